@@ -1,54 +1,25 @@
 #include "CAF.h"
 
-#include <regex>
+#include <algorithm>
+#include <limits>
 
-#include "duneanaobj/StandardRecord/Flat/FlatRecord.h"
-
-#include "util/Logger.h"
+#include "output/TTreeCAFWriter.h"
+#include "util/SRPool.h"
+#include "util/Timing.h"
 
 // fixme: once DIRT-II is done with its work, this will be re-enabled
 //#include "nusystematics/artless/response_helper.hh"
 
-CAF::CAF(const std::string &filename, const std::string &rw_fhicl_filename, bool makeFlatCAF, bool storeGENIE)
-  : pot(std::numeric_limits<decltype(pot)>::signaling_NaN()),  rh(rw_fhicl_filename)
+CAF::CAF(const std::string &filename, const std::string &rw_fhicl_filename, bool makeStructuredCAF, bool makeFlatCAF, bool storeGENIE,
+         const cafmaker::CAFTreeIO & treeIO, cafmaker::GENIEStorage genieStorage)
+  : pot(std::numeric_limits<decltype(pot)>::signaling_NaN()), meta_run(0), meta_subrun(0), rh(rw_fhicl_filename), fGENIEStorage(genieStorage)
 {
-  cafFile = new TFile( filename.c_str(), "RECREATE" );
-
-  cafSR = new TTree("cafTree", "cafTree");
-  cafSRGlobal = new TTree("globalTree", "globalTree");
-  cafMVA = new TTree("mvaTree", "mvaTree");
-  cafPOT = new TTree( "meta", "meta" );
-
-  if (storeGENIE)
-    genie = new TTree( "genieEvt", "genieEvt" );
-
-  if (makeFlatCAF)
-  {
-    // LZ4 is the fastest format to decompress. I get 3x faster loading with
-    // this compared to the default, and the files are only slightly larger.
-    flatCAFFile = new TFile( std::regex_replace(filename, std::regex("\\.root"), ".flat.root").c_str(),
-                             "RECREATE", "",
-                             ROOT::CompressionSettings(ROOT::kLZ4, 1));
-
-    flatCAFTree = new TTree("cafTree", "cafTree");
-
-    flatCAFRecord = new flat::Flat<caf::StandardRecord>(flatCAFTree, "rec", "", 0);
-  }
-  // initialize standard record bits
-  if(cafSR) cafSR->Branch("rec", "caf::StandardRecord", &sr);
-
   // initialize geometric efficiency throw results
   geoEffThrowResults = new std::vector< std::vector < std::vector < uint64_t > > >();
-  cafMVA->Branch("geoEffThrowResults", &geoEffThrowResults);
 
-  // initialize the GENIE record
-  if (genie)
-    genie->Branch( "genie_record", &mcrec );
-
-  cafPOT->Branch( "pot", &pot, "pot/D" );
-  cafPOT->Branch( "run", &meta_run, "run/I" );
-  cafPOT->Branch( "subrun", &meta_subrun, "subrun/I" );
-  cafPOT->Branch( "version", &version, "version/I" );
+  // the writers bind to this, so it has to exist even if none of them stores it
+  if (storeGENIE)
+    mcrec = new genie::NtpMCEventRecord;
 
   // fixme: the following is disabled until DIRT-II finishes on model + uncertainty decisions
 //  // Get list of variations, and make CAF branch for each one
@@ -63,22 +34,24 @@ CAF::CAF(const std::string &filename, const std::string &rw_fhicl_filename, bool
 //    hdr.id = head.systParamId; // TODO is this necessary?
 //    srglobal.wgts.params.push_back(hdr);
 //  }
-  TBranch* br = cafSRGlobal->Branch("global", &srglobal);
-  if(!br) abort();
-  cafSRGlobal->Fill();
+
+  // the global record is complete now, and the writers store it as soon as they're made
+  if (makeStructuredCAF || makeFlatCAF)
+    AddWriter(std::make_unique<cafmaker::TTreeCAFWriter>(*this, filename, makeStructuredCAF, makeFlatCAF, storeGENIE, treeIO));
 }
 
-void CAF::fill()
+void CAF::AddWriter(std::unique_ptr<cafmaker::ICAFWriter> writer)
 {
-  if(cafSR) cafSR->Fill();
-  cafMVA->Fill();
+  fWriters.push_back(std::move(writer));
+}
 
+void CAF::fill()
+{
+  cafmaker::ScopedTimer timer("CAF::fill");
 
-  if(flatCAFFile){
-    flatCAFRecord->Clear();
-    flatCAFRecord->Fill(sr);
-    flatCAFTree->Fill();
-  }
+  for (const auto & writer : fWriters)
+    writer->Fill(*this);
+  fNRecords++;
 }
 
 void CAF::Print()
@@ -91,78 +64,83 @@ void CAF::Print()
 void CAF::fillPOT()
 {
   printf( "Filling metadata\n" );
-  cafPOT->Fill();
+  for (const auto & writer : fWriters)
+    writer->FillPOT(*this);
 }
 
-void CAF::write()
+void CAF::checkpoint()
 {
+  cafmaker::ScopedTimer timer("CAF::checkpoint");
 
-  if(flatCAFFile){
-    flatCAFFile->cd();
-    flatCAFTree->Write();
-
-    for (auto tree : {cafSRGlobal, cafMVA, cafPOT, genie })
-    {
-      if (!tree)
-        continue;
-      auto clone_tree = (TTree*)tree->Clone();
-      clone_tree->Write();
-    }
-    flatCAFFile->Close();
-  }
-
-  if(cafFile){
-    cafFile->cd();
-    cafSR->Write();
+  for (const auto & writer : fWriters)
+    writer->Checkpoint();
+}
 
-    for (auto tree : {cafSRGlobal, cafMVA, cafPOT, genie })
-    {
-      if (!tree)
-        continue;
-      tree->Write();
-      // don't let it get stuck attached to only this file in case we need it again below
-      tree->LoadBaskets();
-      tree->SetDirectory(nullptr);
-    }
-    cafFile->Close();
-  }
+void CAF::write()
+{
+  cafmaker::ScopedTimer timer("CAF::write");
 
+  for (const auto & writer : fWriters)
+    writer->Write();
 }
 
 
-void CAF::setToBS()
+void CAF::setToBS(bool keepCapacity)
 {
   // use default constructors to reset
-  sr = caf::StandardRecord();
+  if (keepCapacity)
+    cafmaker::ResetKeepCapacity(sr);
+  else
+    sr = caf::StandardRecord();
   srglobal = caf::SRGlobal();
 }
 
-int CAF::StoreGENIEEvent(const genie::NtpMCEventRecord *evtIn)
+int CAF::StoreGENIEEvent(const genie::NtpMCEventRecord *evtIn, const cafmaker::GENIEEventRef & ref)
 {
-  // if the GENIE tree is not already pointing to the given address, we can make it happen,
-  // but it will slow things down
-  if (evtIn != mcrec)
+  cafmaker::ScopedTimer timer("CAF::StoreGENIEEvent");
+
+  if (fGENIEStorage == cafmaker::GENIEStorage::kReference)
   {
-    // might be better to throw an exception or something,
-    // since the *user* can't do anything about this,
-    // but all the throw-ing and catch-ing will slow us down even more
-    static bool warned = false;
-    if (!warned)
+    genieRef = ref;
+    int idx = -1;
+    for (const auto & writer : fWriters)
     {
-      cafmaker::LOG_S("CAF::StoreGENIEEvent()").WARNING() << "Repeatedly reassigning the target pointer for output GENIE tree will result in significant performance degredation\n";
-      warned = true;
+      int writerIdx = writer->StoreGENIERef(*this);
+      if (idx < 0)
+        idx = writerIdx;
     }
-
-    genie->SetBranchAddress("genie_record", &evtIn);
+    fNGENIERecords = std::max(fNGENIERecords, static_cast<long long>(idx) + 1);
+    return idx;
   }
 
-  genie->Fill();
+  // the same interaction can be matched by more than one trigger.
+  // it's the same record if it came from the same place in the input, which is much cheaper to check than its contents
+  const bool dedup = fGENIEStorage == cafmaker::GENIEStorage::kDedup && ref.file >= 0;
+  if (dedup)
+  {
+    auto it = fStoredGENIEIdx.find({ref.run, ref.entry});
+    if (it != fStoredGENIEIdx.end())
+      return it->second;
+  }
 
-  // now reset the tree
-  if (evtIn != mcrec)
+  // every writer that stores GENIE records stores all of them, so they all agree on the index
+  int idx = -1;
+  for (const auto & writer : fWriters)
   {
-    genie->SetBranchAddress("genie_record", &mcrec);
+    int writerIdx = writer->StoreGENIEEvent(*this, evtIn);
+    if (idx < 0)
+      idx = writerIdx;
   }
 
-  return genie->GetEntries()-1;
+  if (dedup && idx >= 0)
+    RememberGENIEEvent(ref, idx);
+  fNGENIERecords = std::max(fNGENIERecords, static_cast<long long>(idx) + 1);
+
+  return idx;
+}
+
+void CAF::RememberGENIEEvent(const cafmaker::GENIEEventRef & ref, int idx)
+{
+  if (fGENIEStorage == cafmaker::GENIEStorage::kDedup)
+    fStoredGENIEIdx.emplace(std::make_pair(ref.run, ref.entry), idx);
 }
@@ -1,12 +1,18 @@
 #ifndef CAF_h
 #define CAF_h
 
-#include "TFile.h"
-#include "TTree.h"
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "Framework/Ntuple/NtpMCEventRecord.h"
 #include "duneanaobj/StandardRecord/StandardRecord.h"
 #include "duneanaobj/StandardRecord/SRGlobal.h"
-#include "duneanaobj/StandardRecord/Flat/FwdDeclare.h"
+
+#include "output/ICAFWriter.h"
+#include "truth/GENIEStorage.h"
+#include "util/TreeIO.h"
 
 // fixme: this is a do-nothing replacement for nusystematics stuff until it's re-enabled
 //#include "nusystematics/artless/response_helper.hh"
@@ -18,13 +24,24 @@ namespace nusyst
 class CAF {
 
 public:
-  CAF(const std::string &filename, const std::string &rw_fhicl_filename, bool makeFlatCAF, bool storeGENIE);
+  /// The TTree output (structured and/or flat CAF) is set up here; other outputs can be added with `AddWriter()`.
+  /// The flat CAF, if requested, is written next to `filename`, with '.root' replaced by '.flat.root'.
+  /// A CAF that isn't requested isn't filled at all, so it costs nothing.
+  /// `genieStorage` decides how the GENIE records matched to the interactions are kept, if `storeGENIE`
+  CAF(const std::string &filename, const std::string &rw_fhicl_filename, bool makeStructuredCAF, bool makeFlatCAF, bool storeGENIE,
+      const cafmaker::CAFTreeIO & treeIO = {}, cafmaker::GENIEStorage genieStorage = cafmaker::GENIEStorage::kCopy);
   ~CAF() = default;
   void fill();
   void fillPOT();
+  /// Make everything filled so far survive the job being killed (see `CAFCheckpoint.h`)
+  void checkpoint();
   void write();
   void Print();
-  void setToBS();
+  /// Reset the records.  With `keepCapacity`, the StandardRecord's vectors keep their memory for the next trigger
+  void setToBS(bool keepCapacity = false);
+
+  /// Send the records to another output as well.  Must be done before the first fill()
+  void AddWriter(std::unique_ptr<cafmaker::ICAFWriter> writer);
 
   // Make ntuple variables public so they can be set from other file
   caf::StandardRecord sr;
@@ -38,28 +55,48 @@ public:
   int meta_run, meta_subrun;
   int version;
 
-  TFile * cafFile;
-  TTree * cafSR;
-  TTree * cafSRGlobal;
-  TTree * cafMVA;
-  TTree * cafPOT;
+  // the input .ghep files, in the order GENIEEventRef::file counts them.  only stored with GENIEStorage::kReference
+  std::vector<std::string> ghepFiles;
 
-  // store the GENIE record as a branch, if requested
+  // the GENIE record being stored, if GENIE records are stored
   genie::NtpMCEventRecord * mcrec = nullptr;
-  TTree                   * genie = nullptr;
 
-  /// Callback function that can be used to store a GENIE event in the GENIE tree,
-  /// if client can't manipulate the `genie` tree above directly
+  // where that record is in the input files, if only that is stored
+  cafmaker::GENIEEventRef genieRef;
+
+  cafmaker::GENIEStorage GENIEStorageMode() const { return fGENIEStorage; }
+
+  /// Number of records filled so far
+  long long NRecords() const { return fNRecords; }
+
+  /// Number of GENIE records (or references) stored so far
+  long long NGENIERecords() const { return fNGENIERecords; }
+
+  /// Callback function that can be used to store a GENIE event in the outputs,
+  /// if client can't fill `mcrec` above directly
   ///
   /// \param   evtIn  Memory location where the GENIE record to be copied is
-  /// \return         Index in the TTree of the output where the record was copied
-  int StoreGENIEEvent(const genie::NtpMCEventRecord *evtIn);
+  /// \param   ref    Where that record is in the input .ghep files
+  /// \return         Index in the output where the record (or its reference) was stored (-1 if no output stores GENIE records).
+  ///                 With GENIEStorage::kDedup, a record from the same place in the input as one already stored gets that one's index
+  ///                 (a `ref` without a file, i.e. from nowhere known, is always stored)
+  int StoreGENIEEvent(const genie::NtpMCEventRecord *evtIn, const cafmaker::GENIEEventRef & ref = {});
 
-  TFile * flatCAFFile                             = nullptr;
-  TTree * flatCAFTree                             = nullptr;
-  flat::Flat<caf::StandardRecord>* flatCAFRecord  = nullptr;
+  /// Tell GENIEStorage::kDedup that the record at `ref` in the input is already at `idx` in the output
+  /// (e.g., when the output is rebuilt from a checkpoint, where only the records were kept)
+  void RememberGENIEEvent(const cafmaker::GENIEEventRef & ref, int idx);
 
   nusyst::response_helper rh;
+
+private:
+  std::vector<std::unique_ptr<cafmaker::ICAFWriter>> fWriters;
+
+  cafmaker::GENIEStorage fGENIEStorage;
+  long long fNRecords = 0;
+  long long fNGENIERecords = 0;
+  /// Output index of each record stored so far, by its (run, entry) in the input .ghep files (GENIEStorage::kDedup only).
+  /// Each run has a file of its own, so that's enough to identify a record
+  std::map<std::pair<unsigned long, unsigned int>, int> fStoredGENIEIdx;
 };
 
 #endif
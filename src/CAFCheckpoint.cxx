@@ -0,0 +1,146 @@
+#include "CAFCheckpoint.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include "CAF.h"
+#include "util/Logger.h"
+#include "util/OutputFilename.h"
+
+namespace cafmaker
+{
+  // -----------------------------------------------------------
+  std::string CheckpointFilename(const std::string & cafFilename)
+  {
+    return util::CompanionFilename(cafFilename, ".checkpoint.json");
+  }
+
+  // -----------------------------------------------------------
+  void WriteCheckpoint(const std::string & checkpointFilename, const CheckpointState & state)
+  {
+    const std::string tmpFilename = checkpointFilename + ".tmp";
+    {
+      std::ofstream outFile(tmpFilename);
+      if (!outFile)
+        throw std::runtime_error("Couldn't open checkpoint file '" + tmpFilename + "' for writing");
+      outFile << nlohmann::json{
+        {"file",       state.file},
+        {"next_group", state.nextGroup},
+        {"pot",        state.pot},
+        {"n_records",  state.nRecords},
+        {"n_genie",    state.nGENIE},
+      }.dump(2) << "\n";
+      if (!outFile.flush())
+        throw std::runtime_error("Couldn't write checkpoint file '" + tmpFilename + "'");
+    }
+
+    if (std::rename(tmpFilename.c_str(), checkpointFilename.c_str()) != 0)
+      throw std::runtime_error("Couldn't move checkpoint file '" + tmpFilename + "' to '" + checkpointFilename + "'");
+  }
+
+  // -----------------------------------------------------------
+  CheckpointState ReadCheckpoint(const std::string & checkpointFilename)
+  {
+    std::ifstream inFile(checkpointFilename);
+    if (!inFile)
+      throw std::runtime_error("Couldn't open checkpoint file '" + checkpointFilename + "'.  Was the job run with CheckpointInterval > 0?");
+
+    CheckpointState state;
+    try
+    {
+      nlohmann::json json = nlohmann::json::parse(inFile);
+      state.file = json.at("file").get<std::string>();
+      state.nextGroup = json.at("next_group").get<int>();
+      state.pot = json.at("pot").get<double>();
+      state.nRecords = json.at("n_records").get<long long>();
+      state.nGENIE = json.at("n_genie").get<long long>();
+    }
+    catch (const nlohmann::json::exception & e)
+    {
+      throw std::runtime_error("Malformed checkpoint file '" + checkpointFilename + "': " + e.what());
+    }
+
+    return state;
+  }
+
+  // -----------------------------------------------------------
+  void ReplayCheckpoint(CAF & caf, const CheckpointState & state)
+  {
+    std::unique_ptr<TFile> inFile(TFile::Open(state.file.c_str(), "READ"));
+    if (!inFile || inFile->IsZombie())
+      throw std::runtime_error("Couldn't open the checkpointed CAF '" + state.file + "'");
+
+    auto inSR = inFile->Get<TTree>("cafTree");
+    if (!inSR || inSR->GetEntries() < state.nRecords)
+      throw std::runtime_error("Checkpointed CAF '" + state.file + "' has fewer than the " + std::to_string(state.nRecords)
+                               + " records in the checkpoint.  Was it made with 'structured' in OutputFormats?");
+
+    // the GENIE records first, so that they're all in place (in the original order) before the interactions pointing at them are
+    if (state.nGENIE > 0)
+    {
+      const bool refs = caf.GENIEStorageMode() == GENIEStorage::kReference;
+      auto inGENIE = inFile->Get<TTree>(refs ? "genieRef" : "genieEvt");
+      if (!inGENIE || inGENIE->GetEntries() < state.nGENIE)
+        throw std::runtime_error("Checkpointed CAF '" + state.file + "' has fewer than the " + std::to_string(state.nGENIE)
+                                 + " entries in the checkpoint in its '" + (refs ? "genieRef" : "genieEvt") + "' tree.  "
+                                 + "Was it made with the same GENIEStorage?");
+
+      if (refs)
+      {
+        inGENIE->SetBranchAddress("file", &caf.genieRef.file);
+        inGENIE->SetBranchAddress("run", &caf.genieRef.run);
+        inGENIE->SetBranchAddress("entry", &caf.genieRef.entry);
+      }
+      else
+        inGENIE->SetBranchAddress("genie_record", &caf.mcrec);
+
+      // the records were already de-duplicated the first time around, so every one of them is stored again.
+      // (GENIEStorage::kDedup is told where they came from below, from the interactions pointing at them)
+      for (Long64_t entry = 0; entry < state.nGENIE; entry++)
+      {
+        inGENIE->GetEntry(entry);
+        caf.StoreGENIEEvent(caf.mcrec, refs ? caf.genieRef : cafmaker::GENIEEventRef{});
+      }
+      inGENIE->ResetBranchAddresses();
+    }
+
+    caf::StandardRecord * rec = &caf.sr;
+    inSR->SetBranchAddress("rec", &rec);
+    auto inMVA = inFile->Get<TTree>("mvaTree");
+    if (inMVA)
+      inMVA->SetBranchAddress("geoEffThrowResults", &caf.geoEffThrowResults);
+    for (Long64_t entry = 0; entry < state.nRecords; entry++)
+    {
+      inSR->GetEntry(entry);
+      if (inMVA)
+        inMVA->GetEntry(entry);
+
+      // interaction IDs are run * 1e6 + the entry in that run's .ghep file (see TruthMatcher)
+      for (const caf::SRTrueInteraction & nu : caf.sr.mc.nu)
+      {
+        if (nu.genieIdx < 0)
+          continue;
+        GENIEEventRef ref;
+        ref.entry = static_cast<unsigned int>(nu.id % 1000000);
+        ref.run = static_cast<unsigned long>((nu.id - ref.entry) / 1000000);
+        caf.RememberGENIEEvent(ref, nu.genieIdx);
+      }
+      caf.fill();
+    }
+    inSR->ResetBranchAddresses();
+    if (inMVA)
+      inMVA->ResetBranchAddresses();
+
+    caf.pot = state.pot;
+
+    LOG_S("ReplayCheckpoint()").INFO() << "Restored " << state.nRecords << " records and " << state.nGENIE
+                                       << " GENIE entries from '" << state.file << "'\n";
+  }
+}
@@ -0,0 +1,45 @@
+/// \file CAFCheckpoint.h
+///
+/// Saving enough of a running job's state that it can be continued (`makeCAF --resume`) if it's interrupted
+///
+
+#ifndef ND_CAFMAKER_CAFCHECKPOINT_H
+#define ND_CAFMAKER_CAFCHECKPOINT_H
+
+#include <string>
+
+class CAF;
+
+namespace cafmaker
+{
+  /// Where a job was at its last checkpoint.  Kept in a small JSON file next to the CAF
+  struct CheckpointState
+  {
+    std::string file;          ///< the structured CAF holding the records completed so far
+    int nextGroup = 0;         ///< index of the first trigger group that isn't in `file` yet
+    double pot = 0;            ///< POT accumulated over the groups before that
+    long long nRecords = 0;    ///< entries of `file`'s 'cafTree' (and 'mvaTree') that belong to those groups
+    long long nGENIE = 0;      ///< likewise for its 'genieEvt' (or 'genieRef') tree
+  };
+
+  /// The checkpoint file that goes with a CAF: '.root' replaced by '.checkpoint.json'
+  std::string CheckpointFilename(const std::string & cafFilename);
+
+  /// Write the checkpoint file.  It's written under a temporary name and then renamed,
+  /// so an interruption while writing leaves the previous checkpoint intact
+  void WriteCheckpoint(const std::string & checkpointFilename, const CheckpointState & state);
+
+  /// Read back a checkpoint file written by WriteCheckpoint().  Throws if it's missing or malformed
+  CheckpointState ReadCheckpoint(const std::string & checkpointFilename);
+
+  /// \brief Store the records saved in a checkpoint again, in a freshly made CAF
+  ///
+  /// The first `state.nRecords` records and `state.nGENIE` GENIE records (or references) in `state.file`
+  /// go through `caf`'s writers exactly as they did the first time, so the outputs
+  /// (flat, RNTuple, ... as well as the structured CAF) all pick up where the checkpoint left off.
+  /// Anything in `state.file` after that (from ROOT's own AutoSaves since the checkpoint) is ignored.
+  /// `caf.pot` is set to the POT at the checkpoint.
+  void ReplayCheckpoint(CAF & caf, const CheckpointState & state);
+}
+
+#endif //ND_CAFMAKER_CAFCHECKPOINT_H
@@ -0,0 +1,174 @@
+#include "CAFMerge.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include "duneanaobj/StandardRecord/StandardRecord.h"
+
+#include "util/Logger.h"
+
+namespace
+{
+  TTree * GetTree(TFile & file, const std::string & name, bool required = true)
+  {
+    auto tree = file.Get<TTree>(name.c_str());
+    if (!tree && required)
+      throw std::runtime_error("Input file '" + std::string(file.GetName()) + "' has no '" + name + "' tree.  Is it a CAF?");
+    return tree;
+  }
+}
+
+namespace cafmaker
+{
+  // -----------------------------------------------------------
+  void MergeCAFs(const std::string & outFilename, const std::vector<std::string> & inFilenames)
+  {
+    auto LOG = [&]() -> const cafmaker::Logger & { return cafmaker::LOG_S("MergeCAFs()"); };
+
+    if (inFilenames.empty())
+      throw std::invalid_argument("No input CAFs to merge");
+
+    TFile outFile(outFilename.c_str(), "RECREATE");
+    TTree * outSR = nullptr;
+    TTree * outSRGlobal = nullptr;
+    TTree * outMVA = nullptr;
+    TTree * outGENIE = nullptr;
+
+    double pot = 0;
+    int run = 0;
+    int subrun = 0;
+    int version = 0;
+    std::vector<std::string> ghepFiles;
+
+    for (std::size_t fileIdx = 0; fileIdx < inFilenames.size(); fileIdx++)
+    {
+      const std::string & inFilename = inFilenames[fileIdx];
+      std::unique_ptr<TFile> inFile(TFile::Open(inFilename.c_str(), "READ"));
+      if (!inFile || inFile->IsZombie())
+        throw std::runtime_error("Couldn't open input CAF '" + inFilename + "'");
+
+      TTree * inSR = GetTree(*inFile, "cafTree");
+      // not there if 'geoEffThrowResults' was excluded from the output
+      TTree * inMVA = GetTree(*inFile, "mvaTree", false);
+      TTree * inMeta = GetTree(*inFile, "meta");
+      // the GENIE records themselves, or (GENIEStorage 'reference') only where they are in the .ghep files
+      TTree * inGENIE = GetTree(*inFile, "genieEvt", false);
+      if (!inGENIE)
+        inGENIE = GetTree(*inFile, "genieRef", false);
+
+      outFile.cd();
+      if (fileIdx == 0)
+      {
+        // the global tree is the same for every shard
+        outSRGlobal = GetTree(*inFile, "globalTree")->CloneTree(-1, "fast");
+        outSR = inSR->CloneTree(0);
+        if (inMVA)
+          outMVA = inMVA->CloneTree(0);
+        if (inGENIE)
+          outGENIE = inGENIE->CloneTree(0);
+      }
+      else if (static_cast<bool>(inMVA) != static_cast<bool>(outMVA))
+        throw std::runtime_error("Input CAF '" + inFilename + "' " + (inMVA ? "has" : "doesn't have")
+                                 + " an MVA tree, but '" + inFilenames.front() + "' " + (inMVA ? "doesn't" : "does"));
+      else if (static_cast<bool>(inGENIE) != static_cast<bool>(outGENIE))
+        throw std::runtime_error("Input CAF '" + inFilename + "' " + (inGENIE ? "has" : "doesn't have")
+                                 + " a GENIE tree, but '" + inFilenames.front() + "' " + (inGENIE ? "doesn't" : "does"));
+      else if (inGENIE && std::string(inGENIE->GetName()) != outGENIE->GetName())
+        throw std::runtime_error("Input CAF '" + inFilename + "' has a '" + inGENIE->GetName() + "' tree, but '"
+                                 + inFilenames.front() + "' has '" + outGENIE->GetName() + "'");
+
+      // this file's GENIE records land after the ones already copied,
+      // so the interactions' indices into them need to be shifted by as much
+      const Long64_t genieOffset = outGENIE ? outGENIE->GetEntries() : 0;
+      if (genieOffset == 0)
+        outSR->CopyEntries(inSR, -1, "fast");
+      else
+      {
+        caf::StandardRecord * rec = nullptr;
+        inSR->SetBranchAddress("rec", &rec);
+        outSR->SetBranchAddress("rec", &rec);
+        for (Long64_t entry = 0; entry < inSR->GetEntries(); entry++)
+        {
+          inSR->GetEntry(entry);
+          for (caf::SRTrueInteraction & nu : rec->mc.nu)
+          {
+            if (nu.genieIdx >= 0)
+              nu.genieIdx += static_cast<int>(genieOffset);
+          }
+          outSR->Fill();
+        }
+        outSR->ResetBranchAddresses();
+        inSR->ResetBranchAddresses();
+        delete rec;
+      }
+      if (outMVA)
+        outMVA->CopyEntries(inMVA, -1, "fast");
+      if (outGENIE)
+        outGENIE->CopyEntries(inGENIE, -1, "fast");
+
+      double filePOT = 0;
+      int fileRun = 0;
+      int fileSubrun = 0;
+      int fileVersion = 0;
+      std::vector<std::string> * fileGHEPFiles = nullptr;
+      inMeta->SetBranchAddress("pot", &filePOT);
+      inMeta->SetBranchAddress("run", &fileRun);
+      inMeta->SetBranchAddress("subrun", &fileSubrun);
+      inMeta->SetBranchAddress("version", &fileVersion);
+      if (inMeta->GetBranch("ghep_files"))
+        inMeta->SetBranchAddress("ghep_files", &fileGHEPFiles);
+      for (Long64_t entry = 0; entry < inMeta->GetEntries(); entry++)
+      {
+        inMeta->GetEntry(entry);
+
+        // a shard that didn't get any triggers never set its POT
+        if (!std::isnan(filePOT))
+          pot += filePOT;
+
+        if (fileIdx == 0 && entry == 0)
+        {
+          run = fileRun;
+          subrun = fileSubrun;
+          version = fileVersion;
+          if (fileGHEPFiles)
+            ghepFiles = *fileGHEPFiles;
+        }
+        else if (fileRun != run || fileSubrun != subrun)
+          LOG().WARNING() << "Input CAF '" << inFilename << "' is from run " << fileRun << ", subrun " << fileSubrun
+                          << ", but the first input is from run " << run << ", subrun " << subrun << "\n";
+
+        // the GENIE references are indices into this list, so it has to be the same everywhere
+        if (fileGHEPFiles && *fileGHEPFiles != ghepFiles)
+          throw std::runtime_error("Input CAF '" + inFilename + "' was made from different .ghep files than '" + inFilenames.front()
+                                   + "', so their GENIE references can't be merged");
+      }
+      inMeta->ResetBranchAddresses();
+      delete fileGHEPFiles;
+
+      LOG().INFO() << "Added " << inSR->GetEntries() << " records from '" << inFilename << "'"
+                   << (genieOffset > 0 ? " (GENIE indices shifted by " + std::to_string(genieOffset) + ")" : "") << "\n";
+    }
+
+    outFile.cd();
+    auto outMeta = new TTree("meta", "meta");
+    outMeta->Branch("pot", &pot, "pot/D");
+    outMeta->Branch("run", &run, "run/I");
+    outMeta->Branch("subrun", &subrun, "subrun/I");
+    outMeta->Branch("version", &version, "version/I");
+    if (outGENIE && std::string(outGENIE->GetName()) == "genieRef")
+      outMeta->Branch("ghep_files", &ghepFiles);
+    outMeta->Fill();
+
+    std::cout << "Merged " << inFilenames.size() << " CAFs (" << outSR->GetEntries() << " records, " << pot << " POT) into '" << outFilename << "'\n";
+    for (TTree * tree : {outSR, outSRGlobal, outMVA, outMeta, outGENIE})
+    {
+      if (tree)
+        tree->Write();
+    }
+    outFile.Close();
+  }
+}
@@ -0,0 +1,27 @@
+/// \file CAFMerge.h
+///
+/// Combine partial CAFs (e.g., from `makeCAF --shard` jobs) into one
+///
+
+#ifndef ND_CAFMAKER_CAFMERGE_H
+#define ND_CAFMAKER_CAFMERGE_H
+
+#include <string>
+#include <vector>
+
+namespace cafmaker
+{
+  /// \brief Concatenate structured CAFs, in the order given, into a new file
+  ///
+  /// `mvaTree` and `genieEvt` (or `genieRef`) are fast-cloned (their compressed baskets are copied as-is).
+  /// So is `cafTree`, except where an input's GENIE records land after others in the output:
+  /// those records' `genieIdx` have to be shifted, so that input's `cafTree` is rewritten entry by entry.
+  /// The `meta` POT is summed (run, subrun and version come from the first input),
+  /// and `globalTree` is taken from the first input.  Inputs with GENIE references must all list the same `ghep_files`.
+  /// `mvaTree` and the GENIE tree may be absent (pruned or not stored), but then they must be absent from every input.
+  ///
+  /// Flat CAFs aren't handled here.
+  void MergeCAFs(const std::string & outFilename, const std::vector<std::string> & inFilenames);
+}
+
+#endif //ND_CAFMAKER_CAFMERGE_H
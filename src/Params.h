@@ -28,6 +28,20 @@ namespace cafmaker
 
   };
 
+  /// How one output tree is written.  Anything not given keeps ROOT's default
+  struct TreeIOConfig
+  {
+    fhicl::Atom<std::string> compressionAlgorithm { fhicl::Name("CompressionAlgorithm"), fhicl::Comment("Compression algorithm: ZSTD, LZ4, ZLIB or LZMA.  Empty keeps the output file's setting"), "" };
+    fhicl::Atom<int> compressionLevel { fhicl::Name("CompressionLevel"), fhicl::Comment("Compression level (0-9).  -1 means ROOT's default for the algorithm"), -1 };
+    fhicl::Atom<int> basketSize { fhicl::Name("BasketSize"), fhicl::Comment("Initial basket size, in bytes, for every branch.  0 keeps ROOT's default"), 0 };
+    fhicl::OptionalAtom<long long> autoFlush { fhicl::Name("AutoFlush"), fhicl::Comment("Passed to TTree::SetAutoFlush(): > 0 flushes every this-many entries, < 0 every this-many bytes") };
+    fhicl::OptionalAtom<long long> autoSave { fhicl::Name("AutoSave"), fhicl::Comment("Passed to TTree::SetAutoSave(): > 0 saves the tree header every this-many entries, < 0 every this-many bytes") };
+
+    // ROOT does this itself at the first AutoFlush (30 MB by default), which, for big records, can be many entries in
+    fhicl::Atom<unsigned int> autoTuneEntries { fhicl::Name("AutoTuneEntries"), fhicl::Comment("Resize the baskets (TTree::OptimizeBaskets()) to fit the first this-many entries.  0 disables"), 0 };
+    fhicl::Atom<long long> autoTuneMemory { fhicl::Name("AutoTuneMemory"), fhicl::Comment("Total basket memory, in bytes, that the auto-tuning distributes among the branches"), 30000000 };
+  };
+
   struct ControlConfig
   {
     // these are mandatory and have no default values
@@ -41,6 +55,8 @@ namespace cafmaker
 
     // these are optional, but will change the contents of the output CAF if supplied
     fhicl::OptionalAtom<std::string> ndlarRecoFile  { fhicl::Name{"NDLArRecoFile"}, fhicl::Comment("Input ND-LAr (ML) reco .h5 file") };
+    fhicl::Atom<unsigned int> ndlarReadBlockSize { fhicl::Name{"NDLArReadBlockSize"}, fhicl::Comment("Read the ND-LAr (ML) reco products for this many consecutive events at once, in one read per dataset.  1 reads each event separately"), 1 };
+    fhicl::Atom<unsigned int> ndlarReadAhead { fhicl::Name{"NDLArReadAhead"}, fhicl::Comment("Read the ND-LAr (ML) reco products for up to this many upcoming triggers on a background thread while the current one is filled.  0 disables.  Ignored unless NumThreads is 1 and AsyncWrite is off"), 0 };
     fhicl::OptionalAtom<std::string> tmsRecoFile  { fhicl::Name{"TMSRecoFile"}, fhicl::Comment("Input TMS reco .root file") };
     fhicl::OptionalAtom<std::string> sandRecoFile  { fhicl::Name{"SANDRecoFile"}, fhicl::Comment("Input SAND reco .root file") };
     fhicl::OptionalAtom<std::string> minervaRecoFile  { fhicl::Name{"MINERVARecoFile"}, fhicl::Comment("Input MINERVA reco .root file") };
@@ -48,6 +64,22 @@ namespace cafmaker
     
     // this is optional by way of the default value. Will result in an extra output file if enabled
     fhicl::Atom<bool> makeFlatCAF { fhicl::Name{"MakeFlatCAF"}, fhicl::Comment("Make 'flat' CAF in addition to structured CAF?"), true };
+    fhicl::OptionalSequence<std::string> outputFormats { fhicl::Name{"OutputFormats"}, fhicl::Comment("Which CAFs to write: any of 'structured', 'flat', 'rntuple' (written as .rntuple.root, compressed per CAFTreeIO) and 'hdf5' (the flat record as HDF5 columns, written as .flat.h5).  Takes precedence over MakeFlatCAF") };
+    fhicl::Atom<unsigned int> hdf5ChunkSize        { fhicl::Name{"HDF5ChunkSize"},        fhicl::Comment("Rows per chunk of each column in the HDF5 flat CAF"), 4096 };
+    fhicl::Atom<unsigned int> hdf5CompressionLevel { fhicl::Name{"HDF5CompressionLevel"}, fhicl::Comment("gzip level (0-9) for the HDF5 flat CAF's columns.  0 doesn't compress"), 4 };
+
+    // how the matched GENIE records go into 'genieEvt' (or 'genieRef').  SRTrueInteraction::genieIdx indexes that tree either way
+    fhicl::Atom<std::string> genieStorage { fhicl::Name{"GENIEStorage"}, fhicl::Comment("'copy' stores the GENIE record every time an interaction is matched, 'dedup' stores each distinct record once, 'reference' stores only the record's (file, run, entry) in GHEPFiles, with the files listed in 'meta'"), "copy" };
+
+    // both default to nothing
+    fhicl::OptionalSequence<std::string> excludeBranches { fhicl::Name{"ExcludeBranches"}, fhicl::Comment("Branches not to write (with everything below them), e.g. 'rec.mc.nu.sec', 'rec.nd.lar.flashes.*' or 'geoEffThrowResults'.  '*' and '?' are wildcards.  Applies to the structured, flat and HDF5 CAFs") };
+    fhicl::OptionalSequence<std::string> includeBranches { fhicl::Name{"IncludeBranches"}, fhicl::Comment("Exceptions to ExcludeBranches, e.g. 'rec.mc.nu.prim.pdg' when excluding 'rec.mc.nu.prim'") };
+
+    // compression and basket tuning for each output tree.  the flat CAF is LZ4 level 1 unless told otherwise
+    fhicl::Table<TreeIOConfig> cafTreeIO     { fhicl::Name{"CAFTreeIO"},     fhicl::Comment("I/O settings for the structured CAF's 'cafTree'") };
+    fhicl::Table<TreeIOConfig> genieTreeIO   { fhicl::Name{"GENIETreeIO"},   fhicl::Comment("I/O settings for the 'genieEvt' (or 'genieRef') tree") };
+    fhicl::Table<TreeIOConfig> mvaTreeIO     { fhicl::Name{"MVATreeIO"},     fhicl::Comment("I/O settings for the 'mvaTree' tree") };
+    fhicl::Table<TreeIOConfig> flatCAFTreeIO { fhicl::Name{"FlatCAFTreeIO"}, fhicl::Comment("I/O settings for the flat CAF's 'cafTree'") };
 
     fhicl::Atom<bool> ForceDisableIFBeam { fhicl::Name("ForceDisableIFBeam"), fhicl::Comment("Forcefully disable IFBeam interface"), false}; //Disable IFBeam interface when needed (use case: running simulation without GENIE/edepsim)
 
@@ -56,6 +88,26 @@ namespace cafmaker
     fhicl::Atom<int>  numevts { fhicl::Name("NumEvts"), fhicl::Comment("Number of events to process (-1 means 'all')"), -1 };
     fhicl::Atom<int>  seed    { fhicl::Name("Seed"), fhicl::Comment("Random seed to use"), -1 };  // use the run number by default
 
+    // split the trigger groups into NumShards contiguous pieces of about equal estimated cost, and only process one.
+    // the partial CAFs can be combined afterwards with `makeCAF --merge`.  overrides FirstEvt and NumEvts
+    fhicl::Atom<unsigned int> shardIndex { fhicl::Name("ShardIndex"), fhicl::Comment("Which shard (0 to NumShards-1) of the trigger groups to process"), 0 };
+    fhicl::Atom<unsigned int> numShards  { fhicl::Name("NumShards"), fhicl::Comment("Number of shards the trigger groups are split into (1 means no sharding)"), 1 };
+
+    // output is identical regardless of the number of threads
+    fhicl::Atom<unsigned int> numThreads { fhicl::Name("NumThreads"), fhicl::Comment("Number of worker threads filling trigger groups in parallel (1 means run serially)"), 1 };
+    fhicl::Atom<bool> reuseRecordMemory { fhicl::Name("ReuseRecordMemory"), fhicl::Comment("Between triggers, clear the StandardRecord's vectors but keep their memory, and reuse its true interactions, tracks and showers, instead of freeing it all and reallocating"), true };
+    fhicl::Atom<bool> asyncWrite { fhicl::Name("AsyncWrite"), fhicl::Comment("Serialize and write finished records on a dedicated thread while later triggers are being filled"), false };
+    fhicl::Atom<unsigned int> pipelineDepth { fhicl::Name("PipelineDepth"), fhicl::Comment("Maximum number of trigger groups being filled at once, and separately waiting to be written.  0 means twice NumThreads"), 0 };
+
+    // the flat cafTree has a top-level branch per variable and gains the most.
+    // the structured cafTree is one top-level branch ('rec'), so it's still filled and compressed by one thread at a time
+    fhicl::Atom<unsigned int> outputCompressionThreads { fhicl::Name("OutputCompressionThreads"), fhicl::Comment("Number of threads ROOT may use to fill and compress output tree baskets in parallel (ROOT implicit multithreading).  0 disables"), 0 };
+
+    // a job that's interrupted (including by SIGTERM, which stops it cleanly after the groups in progress) can be continued with `makeCAF --resume`
+    fhicl::Atom<unsigned int> checkpointInterval { fhicl::Name("CheckpointInterval"), fhicl::Comment("Every this-many trigger groups, save the output trees and record how far the job got in a .checkpoint.json next to the CAF.  Needs the structured CAF.  0 disables"), 0 };
+
+    fhicl::Atom<bool> timingReport { fhicl::Name("TimingReport"), fhicl::Comment("Time each stage (trigger loading, grouping, each filler, truth lookups, IFBeam, output) and write a JSON summary next to the CAF (as .timing.json)"), false };
+
     // 100 us is default
     fhicl::Atom<unsigned int>  trigMatchDT { fhicl::Name("TriggerMatchDeltaT"), fhicl::Comment("Maximum time difference, in ns, between triggers to be considered a match"), 100000 };
 
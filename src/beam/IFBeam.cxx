@@ -8,6 +8,7 @@
 #include "IFBeam.h"
 #include "util/Logger.h"
 #include "util/IFBeamUtils.h"
+#include "util/Timing.h"
 #include <curl/curl.h>
 #include <regex>
 #include <sstream>
@@ -20,10 +21,14 @@ namespace cafmaker
 {
 
   
-  IFBeam::IFBeam(const std::vector<TriggerGroup>& groupedTriggers, bool is_data) {
+  IFBeam::IFBeam(const TriggersByFiller& triggersByFiller, bool is_data) {
       if (is_data)
-  	loadBeamSpills(groupedTriggers); // Load all beam spills upon instantiation if data
+  	loadBeamSpills(triggersByFiller); // Load all beam spills upon instantiation if data
   }
+
+  IFBeam::IFBeam(BeamSpills spills)
+    : beamSpills(std::move(spills))
+  {}
   
   std::string IFBeam::createUrl(const std::string& min_time_iso, const std::string& max_time_iso) {
       std::ostringstream url_stream;
@@ -48,16 +53,17 @@ namespace cafmaker
       }
   }
   
-  void IFBeam::loadBeamSpills(const std::vector<TriggerGroup>& groupedTriggers) { //todo: this should return other information as well like horn current, position, etc., querying all devices and storing in a map
+  void IFBeam::loadBeamSpills(const TriggersByFiller& triggersByFiller) { //todo: this should return other information as well like horn current, position, etc., querying all devices and storing in a map
+      cafmaker::ScopedTimer timer("IFBeam::fetch");
       beamSpills.clear();
       double dt = 5.0; //time window to query before and after first and last spill, respectively
       double ms_to_s = 1e-3;
       double min_time = std::numeric_limits<double>::max();
       double max_time = std::numeric_limits<double>::lowest();
-      for (const auto& group : groupedTriggers) {
-          for (const auto& trig : group) {
-              if (!trig.first->IsBeamTrigger(trig.second.triggerType)) continue;
-              double trigger_time = util::getTriggerTime(trig.second);
+      for (const auto& fillerTrigs : triggersByFiller) {
+          for (const auto& trig : fillerTrigs.second) {
+              if (!fillerTrigs.first->IsBeamTrigger(trig.triggerType)) continue;
+              double trigger_time = util::getTriggerTime(trig);
 
               min_time = std::min(min_time, trigger_time - dt);
               max_time = std::max(max_time, trigger_time + dt);
@@ -105,6 +111,7 @@ namespace cafmaker
   }
   
   double IFBeam::getPOT(const cafmaker::Params& par, const TriggerGroup& groupedTrigger, int ii) {
+      cafmaker::ScopedTimer timer("IFBeam::getPOT");
       double pot = 0.0;
       if (!(groupedTrigger.front().first->IsBeamTrigger(groupedTrigger.front().second.triggerType))) return 0.0;
       auto it = std::find_if(beamSpills.begin(), beamSpills.end(),
@@ -10,6 +10,7 @@
 
 #include <Params.h>
 #include "reco/IRecoBranchFiller.h"
+#include <deque>
 #include <string>
 #include <map>
 #include <vector>
@@ -22,7 +23,13 @@ namespace cafmaker
       using BeamSpills = std::map<double, double>;
       using TriggerGroup = std::vector<std::pair<const cafmaker::IRecoBranchFiller*, cafmaker::Trigger>>;
   
-      IFBeam(const std::vector<TriggerGroup>& groupedTriggers, bool is_data);   
+      using TriggersByFiller = std::map<const cafmaker::IRecoBranchFiller*, std::deque<cafmaker::Trigger>>;
+
+      /// The spills queried cover the time span of all the triggers, from every reco filler
+      IFBeam(const TriggersByFiller& triggersByFiller, bool is_data);
+
+      /// Use spills (time in s -> POT) that were already fetched, without querying the database
+      explicit IFBeam(BeamSpills spills);
   
       double getPOT(const cafmaker::Params& par, const TriggerGroup & groupedTrigger, int ii);
    
@@ -31,7 +38,7 @@ namespace cafmaker
       const std::string potDevice = "E:TRTGTD";
       BeamSpills beamSpills;
   
-      void loadBeamSpills(const std::vector<TriggerGroup>& groupedTriggers);
+      void loadBeamSpills(const TriggersByFiller& triggersByFiller);
       std::string createUrl(const std::string& min_time_iso, const std::string& max_time_iso);
       double unitToFactor(const std::string& unit);
   };
@@ -0,0 +1,165 @@
+#include "bench/MicroBench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <stdexcept>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+namespace
+{
+  // ---------------------------------------------------------------------
+  double TimeIt(const cafmaker::bench::Suite::BenchFn & fn, std::size_t nIter)
+  {
+    const auto start = std::chrono::steady_clock::now();
+    fn(nIter);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+namespace cafmaker::bench
+{
+  // ---------------------------------------------------------------------
+  void Suite::Add(const std::string & name, BenchFn fn)
+  {
+    fBenchmarks.emplace_back(name, std::move(fn));
+  }
+
+  // ---------------------------------------------------------------------
+  std::vector<Result> Suite::Run(const std::string & filter, double minTime_s, unsigned int repetitions) const
+  {
+    const std::regex filterRe(filter.empty() ? ".*" : filter);
+    repetitions = std::max(repetitions, 1u);
+
+    std::vector<Result> results;
+    for (const auto & bench : fBenchmarks)
+    {
+      if (!std::regex_search(bench.first, filterRe))
+        continue;
+
+      // grow the iteration count until a repetition is long enough to time reliably,
+      // then extrapolate to the requested time (with a bit of margin)
+      std::size_t nIter = 1;
+      double elapsed = TimeIt(bench.second, nIter);
+      while (elapsed < minTime_s && nIter < (std::size_t(1) << 40))
+      {
+        const double scale = elapsed > 0 ? 1.4 * minTime_s / elapsed : 10.;
+        nIter = std::max(nIter + 1, static_cast<std::size_t>(static_cast<double>(nIter) * std::min(scale, 10.)));
+        elapsed = TimeIt(bench.second, nIter);
+      }
+
+      std::vector<double> nsPerIter{elapsed * 1e9 / static_cast<double>(nIter)};
+      for (unsigned int rep = 1; rep < repetitions; rep++)
+        nsPerIter.push_back(TimeIt(bench.second, nIter) * 1e9 / static_cast<double>(nIter));
+      std::sort(nsPerIter.begin(), nsPerIter.end());
+
+      Result & res = results.emplace_back();
+      res.name = bench.first;
+      res.iterations = nIter;
+      res.ns_per_iter = nsPerIter.size() % 2 == 1 ? nsPerIter[nsPerIter.size() / 2]
+                                                  : 0.5 * (nsPerIter[nsPerIter.size() / 2 - 1] + nsPerIter[nsPerIter.size() / 2]);
+      res.ns_min = nsPerIter.front();
+      res.ns_max = nsPerIter.back();
+    }
+
+    return results;
+  }
+
+  // ---------------------------------------------------------------------
+  void Print(const std::vector<Result> & results)
+  {
+    std::size_t width = 9;
+    for (const Result & res : results)
+      width = std::max(width, res.name.size());
+
+    std::cout << std::left << std::setw(static_cast<int>(width)) << "Benchmark"
+              << std::right << std::setw(16) << "Time (ns)" << std::setw(16) << "Min (ns)" << std::setw(16) << "Max (ns)"
+              << std::setw(14) << "Iterations" << "\n";
+    std::cout << std::string(width + 62, '-') << "\n";
+    for (const Result & res : results)
+    {
+      std::cout << std::left << std::setw(static_cast<int>(width)) << res.name << std::right << std::fixed << std::setprecision(1)
+                << std::setw(16) << res.ns_per_iter << std::setw(16) << res.ns_min << std::setw(16) << res.ns_max
+                << std::setw(14) << res.iterations << "\n";
+    }
+    std::cout << std::defaultfloat;
+  }
+
+  // ---------------------------------------------------------------------
+  void WriteJSON(const std::vector<Result> & results, const std::string & filename)
+  {
+    char dateStr[64];
+    const std::time_t now = std::time(nullptr);
+    std::strftime(dateStr, sizeof(dateStr), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    json doc;
+    doc["context"] = {{"date", dateStr},
+                      {"num_cpus", std::thread::hardware_concurrency()},
+                      {"library_build_type", "release"}};
+
+    doc["benchmarks"] = json::array();
+    for (const Result & res : results)
+    {
+      doc["benchmarks"].push_back({{"name", res.name},
+                                   {"run_name", res.name},
+                                   {"run_type", "iteration"},
+                                   {"iterations", res.iterations},
+                                   {"real_time", res.ns_per_iter},
+                                   {"cpu_time", res.ns_per_iter},
+                                   {"min_time", res.ns_min},
+                                   {"max_time", res.ns_max},
+                                   {"time_unit", "ns"}});
+    }
+
+    std::ofstream out(filename);
+    if (!out)
+      throw std::runtime_error("Couldn't open benchmark output file: " + filename);
+    out << doc.dump(2) << "\n";
+  }
+
+  // ---------------------------------------------------------------------
+  std::vector<Regression> CompareToBaseline(const std::vector<Result> & results,
+                                            const std::string & baseline,
+                                            double tolerance)
+  {
+    std::ifstream in(baseline);
+    if (!in)
+      throw std::runtime_error("Couldn't open benchmark baseline file: " + baseline);
+    const json doc = json::parse(in);
+
+    // Google Benchmark may report in other units
+    const std::map<std::string, double> toNs{{"ns", 1.}, {"us", 1e3}, {"ms", 1e6}, {"s", 1e9}};
+
+    std::map<std::string, double> baselineNs;
+    for (const json & bench : doc.at("benchmarks"))
+    {
+      // aggregates (mean, median, ...) from repeated Google Benchmark runs would double up otherwise
+      if (bench.value("run_type", "iteration") != "iteration")
+        continue;
+      baselineNs[bench.at("name").get<std::string>()] = bench.at("real_time").get<double>()
+                                                        * toNs.at(bench.value("time_unit", "ns"));
+    }
+
+    std::vector<Regression> regressions;
+    for (const Result & res : results)
+    {
+      auto it = baselineNs.find(res.name);
+      if (it == baselineNs.end())
+        continue;
+      if (res.ns_per_iter > it->second * (1. + tolerance))
+        regressions.push_back({res.name, it->second, res.ns_per_iter});
+    }
+
+    return regressions;
+  }
+}
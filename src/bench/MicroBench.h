@@ -0,0 +1,78 @@
+/// \file MicroBench.h
+///
+/// A minimal micro-benchmark harness (loosely modeled on Google Benchmark,
+/// whose JSON output format it also writes, so the usual comparison tools work on it),
+/// plus a comparison against a stored baseline so that slowdowns can fail a CI job.
+///
+
+#ifndef ND_CAFMAKER_MICROBENCH_H
+#define ND_CAFMAKER_MICROBENCH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cafmaker::bench
+{
+  /// Keep the compiler from optimizing away a computation whose result isn't otherwise used
+  template <typename T>
+  inline void DoNotOptimize(const T & value)
+  {
+    asm volatile("" : : "r,m"(value) : "memory");
+  }
+
+  /// Outcome of one benchmark
+  struct Result
+  {
+    std::string name;
+    std::size_t iterations = 0;  ///< per repetition
+    double      ns_per_iter = 0; ///< median over the repetitions
+    double      ns_min = 0;      ///< fastest repetition
+    double      ns_max = 0;      ///< slowest repetition
+  };
+
+  /// One benchmark that got slower than the baseline allows
+  struct Regression
+  {
+    std::string name;
+    double      baseline_ns;
+    double      current_ns;
+  };
+
+  class Suite
+  {
+    public:
+      /// A benchmark body runs the operation under test `nIter` times.
+      /// Anything expensive that shouldn't be timed has to happen when the benchmark is registered.
+      using BenchFn = std::function<void(std::size_t nIter)>;
+
+      void Add(const std::string & name, BenchFn fn);
+
+      /// Run the benchmarks whose names match `filter` (an ECMAScript regex; empty means all).
+      /// The iteration count is raised until one repetition takes at least `minTime_s`,
+      /// then the benchmark is repeated `repetitions` times.
+      std::vector<Result> Run(const std::string & filter, double minTime_s, unsigned int repetitions) const;
+
+    private:
+      std::vector<std::pair<std::string, BenchFn>> fBenchmarks;
+  };
+
+  /// Print the results as a table
+  void Print(const std::vector<Result> & results);
+
+  /// Write the results in Google Benchmark's JSON format
+  void WriteJSON(const std::vector<Result> & results, const std::string & filename);
+
+  /// \brief Compare against a baseline JSON file (as written by WriteJSON(), or by Google Benchmark)
+  ///
+  /// \param results    Results of this run
+  /// \param baseline   Name of the baseline file
+  /// \param tolerance  Allowed fractional slowdown (0.1 means 10% slower is still OK)
+  /// \return  The benchmarks slower than the baseline by more than the tolerance.
+  ///          Benchmarks missing from either side are ignored.
+  std::vector<Regression> CompareToBaseline(const std::vector<Result> & results,
+                                            const std::string & baseline,
+                                            double tolerance);
+}
+
+#endif //ND_CAFMAKER_MICROBENCH_H
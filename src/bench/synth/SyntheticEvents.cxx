@@ -0,0 +1,235 @@
+#include "SyntheticEvents.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+  // roughly the ND-LAr active volume, in cm
+  const std::array<double, 3> kVolumeMin{-350., -216., 417.};
+  const std::array<double, 3> kVolumeMax{ 350.,   82., 916.};
+
+  const unsigned long int kSpillPeriod_ns = 1200000000;
+  const double kSpillLength_ns = 9600.;
+
+  // ---------------------------------------------------------------------
+  std::array<double, 3> RandomDirection(std::mt19937_64 & rng, double cosThetaMin)
+  {
+    std::uniform_real_distribution<double> cosTheta(cosThetaMin, 1.);
+    std::uniform_real_distribution<double> phi(0, 2 * M_PI);
+    double ct = cosTheta(rng);
+    double st = std::sqrt(std::max(0., 1 - ct * ct));
+    double ph = phi(rng);
+    return {st * std::cos(ph), st * std::sin(ph), ct};
+  }
+
+  // ---------------------------------------------------------------------
+  /// Crude range in LAr (cm) for a particle with the given kinetic energy (GeV)
+  double Range(int pdg, double ke)
+  {
+    switch (std::abs(pdg))
+    {
+      case 13:
+      case 211:
+        return ke / 0.0030;     // minimum ionizing, more or less
+      case 2212:
+        return 0.6 * std::pow(ke / 0.01, 1.75);
+      case 11:
+      case 22:
+      case 111:
+        return 14. * std::log1p(ke / 0.03);   // a few radiation lengths
+      case 2112:
+        return 60.;
+      default:
+        return 0.;
+    }
+  }
+
+  // ---------------------------------------------------------------------
+  cafmaker::synth::Particle MakeParticle(std::mt19937_64 & rng,
+                                         int trackID, int parentID, int pdg, double ke,
+                                         const std::array<double, 3> & dir,
+                                         const std::array<double, 3> & start, double t)
+  {
+    cafmaker::synth::Particle part;
+    part.trackID = trackID;
+    part.parentID = parentID;
+    part.pdg = pdg;
+    part.primary = parentID < 0;
+
+    const double m = cafmaker::synth::Mass(pdg);
+    const double E = m + ke;
+    const double p = std::sqrt(std::max(0., E * E - m * m));
+    part.p4 = {p * dir[0], p * dir[1], p * dir[2], E};
+
+    // neutrinos escape; everything else stops after its range (with some straggling)
+    std::normal_distribution<double> straggle(1., 0.05);
+    const double length = (std::abs(pdg) == 12 || std::abs(pdg) == 14) ? 1000. : Range(pdg, ke) * std::max(0.5, straggle(rng));
+    part.start = start;
+    for (std::size_t axis = 0; axis < 3; axis++)
+      part.end[axis] = start[axis] + length * dir[axis];
+    part.t = t;
+
+    return part;
+  }
+}
+
+namespace cafmaker::synth
+{
+  // ---------------------------------------------------------------------
+  std::size_t Interaction::NPrimaries() const
+  {
+    return std::count_if(particles.begin(), particles.end(), [](const Particle & part) { return part.primary; });
+  }
+
+  // ---------------------------------------------------------------------
+  std::vector<Spill> GenerateSpills(const Config & cfg)
+  {
+    std::mt19937_64 rng(cfg.seed);
+    std::poisson_distribution<int> nInteractions(cfg.meanInteractions);
+    std::poisson_distribution<int> nPrimaries(cfg.meanPrimaries);
+    std::poisson_distribution<int> nSecondaries(cfg.meanSecondaries);
+    std::bernoulli_distribution isCC(cfg.ccFraction);
+    std::bernoulli_distribution coinFlip(0.5);
+    std::gamma_distribution<double> nuEnergy(3., 1.);
+    std::uniform_real_distribution<double> unit(0., 1.);
+    std::exponential_distribution<double> share(1.);
+    std::exponential_distribution<double> secondaryKE(1 / 0.02);
+    auto pick = [&rng](const auto & choices)
+    {
+      return choices[std::uniform_int_distribution<std::size_t>(0, choices.size() - 1)(rng)];
+    };
+
+    // what the hadronic system is made of, by rough abundance
+    const std::vector<int> hadronPdgs{2212, 2212, 2212, 2112, 2112, 211, -211, 111, 22};
+    const std::vector<int> secondaryPdgs{11, 11, 22, 22, 2212, 2112};
+
+    std::vector<Spill> spills(cfg.nSpills);
+    unsigned int evtNum = 0;
+    for (std::size_t spillIdx = 0; spillIdx < cfg.nSpills; spillIdx++)
+    {
+      Spill & spill = spills[spillIdx];
+      spill.id = static_cast<long int>(spillIdx);
+      const unsigned long int t_ns = spillIdx * kSpillPeriod_ns;
+      spill.time_s = t_ns / 1000000000;
+      spill.time_ns = static_cast<unsigned int>(t_ns % 1000000000);
+
+      const int nIxn = nInteractions(rng);
+      spill.interactions.reserve(nIxn);
+      for (int ixnIdx = 0; ixnIdx < nIxn; ixnIdx++)
+      {
+        // TruthMatcher splits interaction IDs back into run and event numbers this way
+        if (evtNum >= 1000000)
+          throw std::out_of_range("Too many interactions (" + std::to_string(evtNum) + ") for one run; the interaction IDs would collide");
+
+        Interaction ixn;
+        ixn.evtNum = evtNum++;
+        ixn.ixnID = static_cast<unsigned long>(cfg.run) * 1000000 + ixn.evtNum;
+
+        const double flavor = unit(rng);
+        ixn.nuPdg = flavor < 0.92 ? 14 : (flavor < 0.98 ? -14 : 12);
+        ixn.targetPdg = 1000180400;   // argon-40
+        ixn.hitNucPdg = coinFlip(rng) ? 2212 : 2112;
+        ixn.isCC = isCC(rng);
+        ixn.Enu = 0.3 + nuEnergy(rng);
+        for (std::size_t axis = 0; axis < 3; axis++)
+          ixn.vtx[axis] = kVolumeMin[axis] + unit(rng) * (kVolumeMax[axis] - kVolumeMin[axis]);
+        ixn.t = unit(rng) * kSpillLength_ns;
+
+        // the outgoing lepton takes most of the energy.  the rest gets shared out among the hadrons
+        const double y = 0.05 + 0.65 * unit(rng);
+        int leptonPdg = ixn.nuPdg;
+        if (ixn.isCC)
+          leptonPdg = (ixn.nuPdg > 0 ? 1 : -1) * (std::abs(ixn.nuPdg) - 1);
+        const double leptonKE = std::max(0.01, ixn.Enu * (1 - y) - Mass(leptonPdg));
+        ixn.particles.push_back(MakeParticle(rng, 0, -1, leptonPdg, leptonKE, RandomDirection(rng, 0.7), ixn.vtx, ixn.t));
+
+        const int nHad = nPrimaries(rng);
+        std::vector<double> shares(nHad);
+        for (double & s : shares)
+          s = share(rng);
+        const double shareSum = std::max(1e-9, std::accumulate(shares.begin(), shares.end(), 0.));
+        for (int hadIdx = 0; hadIdx < nHad; hadIdx++)
+        {
+          const int pdg = pick(hadronPdgs);
+          const double ke = std::max(0.005, ixn.Enu * y * shares[hadIdx] / shareSum);
+          ixn.particles.push_back(MakeParticle(rng, hadIdx + 1, -1, pdg, ke, RandomDirection(rng, -0.2), ixn.vtx, ixn.t));
+        }
+
+        // secondaries hang off the visible primaries, somewhere along their path
+        std::vector<std::size_t> parents;
+        for (std::size_t partIdx = 0; partIdx < ixn.particles.size(); partIdx++)
+        {
+          if (IsVisible(ixn.particles[partIdx].pdg))
+            parents.push_back(partIdx);
+        }
+        const int nSec = parents.empty() ? 0 : nSecondaries(rng);
+        for (int secIdx = 0; secIdx < nSec; secIdx++)
+        {
+          const Particle parent = ixn.particles[pick(parents)];
+          const double frac = unit(rng);
+          std::array<double, 3> start{};
+          for (std::size_t axis = 0; axis < 3; axis++)
+            start[axis] = parent.start[axis] + frac * (parent.end[axis] - parent.start[axis]);
+          const int pdg = pick(secondaryPdgs);
+          ixn.particles.push_back(MakeParticle(rng, static_cast<int>(ixn.particles.size()), parent.trackID, pdg,
+                                               secondaryKE(rng) + 0.001, RandomDirection(rng, -1.), start, parent.t + frac));
+        }
+
+        spill.interactions.push_back(std::move(ixn));
+      } // for (ixnIdx)
+    } // for (spillIdx)
+
+    return spills;
+  }
+
+  // ---------------------------------------------------------------------
+  bool IsTrackLike(int pdg)
+  {
+    switch (std::abs(pdg))
+    {
+      case 13:
+      case 211:
+      case 321:
+      case 2212:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  // ---------------------------------------------------------------------
+  bool IsVisible(int pdg)
+  {
+    switch (std::abs(pdg))
+    {
+      case 12:
+      case 14:
+      case 16:
+      case 2112:
+        return false;
+      default:
+        return true;
+    }
+  }
+
+  // ---------------------------------------------------------------------
+  double Mass(int pdg)
+  {
+    switch (std::abs(pdg))
+    {
+      case 11:   return 0.000511;
+      case 13:   return 0.105658;
+      case 111:  return 0.134977;
+      case 211:  return 0.139570;
+      case 321:  return 0.493677;
+      case 2112: return 0.939565;
+      case 2212: return 0.938272;
+      default:   return 0.;
+    }
+  }
+}
@@ -0,0 +1,91 @@
+/// \file SyntheticEvents.h
+///
+/// A made-up neutrino beam run: spills, the interactions in them, and the particles they produce.
+/// The synthetic input writers all draw from the same instance of it,
+/// so the files they make agree with each other the way real ones would
+/// (same spill times, same interaction IDs, same GEANT4 track IDs).
+///
+
+#ifndef ND_CAFMAKER_SYNTHETICEVENTS_H
+#define ND_CAFMAKER_SYNTHETICEVENTS_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace cafmaker::synth
+{
+  /// Knobs for the synthetic run
+  struct Config
+  {
+    std::size_t   nSpills          = 100;
+    unsigned long seed             = 1;
+    unsigned int  run              = 1;     ///< run number, which ends up in the interaction IDs
+
+    double        meanInteractions = 3.;    ///< mean number of neutrino interactions per spill (Poisson)
+    double        meanPrimaries    = 4.;    ///< mean number of final-state particles per interaction, in addition to the lepton
+    double        meanSecondaries  = 2.;    ///< mean number of GEANT4 daughters per interaction
+    double        ccFraction       = 0.7;   ///< fraction of interactions that are charged-current
+  };
+
+  /// One true particle, GEANT4-style
+  struct Particle
+  {
+    int  trackID;      ///< 0 .. N-1 within the interaction; the primaries come first, in the same order as in the GENIE record
+    int  parentID;     ///< -1 for primaries
+    int  pdg;
+    bool primary;
+
+    std::array<double, 4> p4;      ///< (px, py, pz, E) in GeV
+    std::array<double, 3> start;   ///< in cm, detector coordinates
+    std::array<double, 3> end;     ///< in cm, detector coordinates
+    double t;                      ///< in ns since the spill started
+  };
+
+  /// One neutrino interaction
+  struct Interaction
+  {
+    unsigned long ixnID;    ///< run * 1e6 + evtNum, the convention TruthMatcher uses
+    unsigned int  evtNum;   ///< entry in the GENIE tree and EventId in edep-sim.  counts up across the whole run
+
+    int    nuPdg;
+    int    targetPdg;
+    int    hitNucPdg;
+    bool   isCC;
+    double Enu;                        ///< GeV
+    std::array<double, 3> vtx;         ///< cm
+    double t;                          ///< ns since the spill started
+
+    std::vector<Particle> particles;   ///< primaries first, then secondaries
+
+    std::size_t NPrimaries() const;
+  };
+
+  /// One beam spill.  Every detector records one trigger for it
+  struct Spill
+  {
+    long int          id;        ///< 0 .. nSpills-1
+    unsigned long int time_s;
+    unsigned int      time_ns;
+    std::vector<Interaction> interactions;
+  };
+
+  /// Make up a run's worth of spills.
+  /// The same Config always gives the same spills.
+  ///
+  /// The spills are 1.2 s apart, starting at t = 0, which is also where the TMS reader
+  /// (which doesn't read the trigger times from its file yet) puts them,
+  /// so the triggers from all the files group together.
+  std::vector<Spill> GenerateSpills(const Config & cfg);
+
+  /// Is this particle one that leaves a track (rather than a shower, or nothing)?
+  bool IsTrackLike(int pdg);
+
+  /// Does this particle deposit any energy on its own?
+  bool IsVisible(int pdg);
+
+  /// Particle mass in GeV, for the handful of species the generator makes
+  double Mass(int pdg);
+}
+
+#endif //ND_CAFMAKER_SYNTHETICEVENTS_H
@@ -0,0 +1,43 @@
+/// \file SyntheticWriters.h
+///
+/// Writers that turn a synthetic run (see SyntheticEvents.h) into files
+/// laid out like the ones each of makeCAF's input readers expects.
+///
+/// The contents are made up, but the structure (tree and branch names, HDF5 datasets and types,
+/// how the entries map to triggers and how reco objects point back to the truth)
+/// follows the corresponding reader, so the files exercise the same code paths real inputs do.
+///
+
+#ifndef ND_CAFMAKER_SYNTHETICWRITERS_H
+#define ND_CAFMAKER_SYNTHETICWRITERS_H
+
+#include <string>
+#include <vector>
+
+#include "bench/synth/SyntheticEvents.h"
+
+namespace cafmaker::synth
+{
+  /// SPINE (ML reco) HDF5 file, using the compound types from DLP_h5_classes.h.
+  /// One 'events' row (with region references into the other datasets) per spill
+  void WriteSPINE(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg);
+
+  /// TMS reco file: 'Reco_Tree', 'Line_Candidates' and 'Truth_Info' trees, one entry per interaction
+  /// (and one empty entry for spills without any), consecutive entries sharing a SpillNo
+  void WriteTMS(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg);
+
+  /// MINERvA reco file: the 'minerva' tree, one entry per spill
+  void WriteMINERvA(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg);
+
+  /// Pandora LArRecoND file: the 'LArRecoND' tree, one entry per spill
+  void WritePandora(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg);
+
+  /// Stand-in for a GENIE .ghep.root file: 'gtree' and its header, one entry per interaction
+  void WriteGHEP(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg);
+
+  /// Stand-in for an edep-sim file: the 'EDepSimEvents' tree, one entry per interaction,
+  /// with trajectories (but no energy deposits)
+  void WriteEdepSim(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg);
+}
+
+#endif //ND_CAFMAKER_SYNTHETICWRITERS_H
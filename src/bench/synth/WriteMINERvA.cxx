@@ -0,0 +1,318 @@
+#include "bench/synth/SyntheticWriters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "TFile.h"
+#include "TTree.h"
+
+namespace
+{
+  // the MINERvA planes around ND-LAr, in cm in detector coordinates
+  const double kMnvUpstreamBack_cm   = 400.;
+  const double kMnvDownstreamFront_cm = 930.;
+
+  /// Same shapes as the arrays MINERvARecoBranchFiller reads into
+  struct MnvBuffers
+  {
+    double offsetX, offsetY, offsetZ;
+
+    int ev_trigger_type, ev_gl_gate, ev_gps_time_sec, ev_gps_time_usec;
+    int ev_run, ev_sub_run, ev_gate;
+
+    int    n_tracks;
+    int    trk_index[100], trk_type[100], trk_patrec[100], trk_time_slice[100];
+    double trk_vis_energy[100], trk_theta[100], trk_phi[100];
+    int    trk_hits[100], trk_dof[100];
+    double trk_chi2perDof[100], trk_fitMass[100];
+    int    trk_nodes[100];
+    double trk_node_X[100][300], trk_node_Y[100][300], trk_node_Z[100][300];
+    double trk_node_aX[100][300], trk_node_aY[100][300], trk_node_qOverP[100][300], trk_node_chi2[100][300];
+    int    trk_node_cluster_idx[100][300];
+
+    int    n_blobs_id;
+    int    blob_id_idx[1000], blob_id_subdet[1000], blob_id_history[1000], blob_id_size[1000], blob_id_patrec[1000];
+    double blob_id_e[1000], blob_id_time[1000];
+    int    blob_id_time_slice[1000];
+    double blob_id_startpoint_x[1000], blob_id_startpoint_y[1000], blob_id_startpoint_z[1000];
+    double blob_id_centroid_x[1000], blob_id_centroid_y[1000], blob_id_centroid_z[1000];
+    int    blob_id_clus_idx[1000][1500];
+
+    int       n_mc_trajectories;
+    int       mc_traj_trkid[10000], mc_traj_parentid[10000], mc_traj_pdg[10000];
+    double    mc_traj_hit_e[10000];
+    int       mc_traj_npoints[10000];
+    int       mc_traj_edepsim_trkid[10000];
+    long long mc_traj_edepsim_eventid[10000];
+    double    mc_traj_point_x[10000][5], mc_traj_point_y[10000][5], mc_traj_point_z[10000][5], mc_traj_point_t[10000][5];
+    double    mc_traj_point_px[10000][5], mc_traj_point_py[10000][5], mc_traj_point_pz[10000][5], mc_traj_point_E[10000][5];
+
+    int    n_clusters_id;
+    int    clus_id_size[7500];
+    int    clus_id_hits_idx[7500][60];
+    int    n_mc_id_digits;
+    int    mc_id_mchit_trkid[50000][2];
+    double mc_id_mchit_dE[50000][2];
+
+    int       n_interactions;
+    double    mc_int_vtx[200][4];
+    long long mc_int_edepsimId[200];
+  };
+
+  // ---------------------------------------------------------------------
+  /// A cluster with a single hit, attributed to one true trajectory.
+  /// \return  the cluster's index, or -1 if the buffers are full
+  int AddCluster(MnvBuffers & buf, int trajIdx, double dE)
+  {
+    if (buf.n_clusters_id >= 7500 || buf.n_mc_id_digits >= 50000)
+      return -1;
+
+    const int hit = buf.n_mc_id_digits++;
+    buf.mc_id_mchit_trkid[hit][0] = trajIdx;
+    buf.mc_id_mchit_trkid[hit][1] = -1;
+    buf.mc_id_mchit_dE[hit][0] = dE;
+
+    const int clus = buf.n_clusters_id++;
+    buf.clus_id_size[clus] = 1;
+    buf.clus_id_hits_idx[clus][0] = hit;
+    return clus;
+  }
+}
+
+namespace cafmaker::synth
+{
+  void WriteMINERvA(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg)
+  {
+    std::mt19937_64 rng(cfg.seed + 3);
+    std::normal_distribution<double> posSmear(0., 3.);   // mm
+    std::normal_distribution<double> eSmear(1., 0.15);
+
+    TFile outF(filename.c_str(), "RECREATE");
+    auto tree = new TTree("minerva", "minerva");   // owned by outF
+
+    // too big for the stack
+    auto buf = std::make_unique<MnvBuffers>();
+
+#define MNV_BRANCH(name, leaf) tree->Branch(#name, &buf->name, #name leaf)
+    MNV_BRANCH(offsetX, "/D");
+    MNV_BRANCH(offsetY, "/D");
+    MNV_BRANCH(offsetZ, "/D");
+
+    MNV_BRANCH(ev_trigger_type, "/I");
+    MNV_BRANCH(ev_gl_gate, "/I");
+    MNV_BRANCH(ev_gps_time_sec, "/I");
+    MNV_BRANCH(ev_gps_time_usec, "/I");
+    MNV_BRANCH(ev_run, "/I");
+    MNV_BRANCH(ev_sub_run, "/I");
+    MNV_BRANCH(ev_gate, "/I");
+
+    MNV_BRANCH(n_tracks, "/I");
+    MNV_BRANCH(trk_index, "[n_tracks]/I");
+    MNV_BRANCH(trk_type, "[n_tracks]/I");
+    MNV_BRANCH(trk_patrec, "[n_tracks]/I");
+    MNV_BRANCH(trk_time_slice, "[n_tracks]/I");
+    MNV_BRANCH(trk_vis_energy, "[n_tracks]/D");
+    MNV_BRANCH(trk_theta, "[n_tracks]/D");
+    MNV_BRANCH(trk_phi, "[n_tracks]/D");
+    MNV_BRANCH(trk_hits, "[n_tracks]/I");
+    MNV_BRANCH(trk_dof, "[n_tracks]/I");
+    MNV_BRANCH(trk_chi2perDof, "[n_tracks]/D");
+    MNV_BRANCH(trk_fitMass, "[n_tracks]/D");
+    MNV_BRANCH(trk_nodes, "[n_tracks]/I");
+    MNV_BRANCH(trk_node_X, "[n_tracks][300]/D");
+    MNV_BRANCH(trk_node_Y, "[n_tracks][300]/D");
+    MNV_BRANCH(trk_node_Z, "[n_tracks][300]/D");
+    MNV_BRANCH(trk_node_aX, "[n_tracks][300]/D");
+    MNV_BRANCH(trk_node_aY, "[n_tracks][300]/D");
+    MNV_BRANCH(trk_node_qOverP, "[n_tracks][300]/D");
+    MNV_BRANCH(trk_node_chi2, "[n_tracks][300]/D");
+    MNV_BRANCH(trk_node_cluster_idx, "[n_tracks][300]/I");
+
+    MNV_BRANCH(n_blobs_id, "/I");
+    MNV_BRANCH(blob_id_idx, "[n_blobs_id]/I");
+    MNV_BRANCH(blob_id_subdet, "[n_blobs_id]/I");
+    MNV_BRANCH(blob_id_history, "[n_blobs_id]/I");
+    MNV_BRANCH(blob_id_size, "[n_blobs_id]/I");
+    MNV_BRANCH(blob_id_patrec, "[n_blobs_id]/I");
+    MNV_BRANCH(blob_id_e, "[n_blobs_id]/D");
+    MNV_BRANCH(blob_id_time, "[n_blobs_id]/D");
+    MNV_BRANCH(blob_id_time_slice, "[n_blobs_id]/I");
+    MNV_BRANCH(blob_id_startpoint_x, "[n_blobs_id]/D");
+    MNV_BRANCH(blob_id_startpoint_y, "[n_blobs_id]/D");
+    MNV_BRANCH(blob_id_startpoint_z, "[n_blobs_id]/D");
+    MNV_BRANCH(blob_id_centroid_x, "[n_blobs_id]/D");
+    MNV_BRANCH(blob_id_centroid_y, "[n_blobs_id]/D");
+    MNV_BRANCH(blob_id_centroid_z, "[n_blobs_id]/D");
+    MNV_BRANCH(blob_id_clus_idx, "[n_blobs_id][1500]/I");
+
+    MNV_BRANCH(n_mc_trajectories, "/I");
+    MNV_BRANCH(mc_traj_trkid, "[n_mc_trajectories]/I");
+    MNV_BRANCH(mc_traj_parentid, "[n_mc_trajectories]/I");
+    MNV_BRANCH(mc_traj_pdg, "[n_mc_trajectories]/I");
+    MNV_BRANCH(mc_traj_hit_e, "[n_mc_trajectories]/D");
+    MNV_BRANCH(mc_traj_npoints, "[n_mc_trajectories]/I");
+    MNV_BRANCH(mc_traj_edepsim_trkid, "[n_mc_trajectories]/I");
+    MNV_BRANCH(mc_traj_edepsim_eventid, "[n_mc_trajectories]/L");
+    MNV_BRANCH(mc_traj_point_x, "[n_mc_trajectories][5]/D");
+    MNV_BRANCH(mc_traj_point_y, "[n_mc_trajectories][5]/D");
+    MNV_BRANCH(mc_traj_point_z, "[n_mc_trajectories][5]/D");
+    MNV_BRANCH(mc_traj_point_t, "[n_mc_trajectories][5]/D");
+    MNV_BRANCH(mc_traj_point_px, "[n_mc_trajectories][5]/D");
+    MNV_BRANCH(mc_traj_point_py, "[n_mc_trajectories][5]/D");
+    MNV_BRANCH(mc_traj_point_pz, "[n_mc_trajectories][5]/D");
+    MNV_BRANCH(mc_traj_point_E, "[n_mc_trajectories][5]/D");
+
+    MNV_BRANCH(n_clusters_id, "/I");
+    MNV_BRANCH(clus_id_size, "[n_clusters_id]/I");
+    MNV_BRANCH(clus_id_hits_idx, "[n_clusters_id][60]/I");
+    MNV_BRANCH(n_mc_id_digits, "/I");
+    MNV_BRANCH(mc_id_mchit_trkid, "[n_mc_id_digits][2]/I");
+    MNV_BRANCH(mc_id_mchit_dE, "[n_mc_id_digits][2]/D");
+
+    MNV_BRANCH(n_interactions, "/I");
+    MNV_BRANCH(mc_int_vtx, "[n_interactions][4]/D");
+    MNV_BRANCH(mc_int_edepsimId, "[n_interactions]/L");
+#undef MNV_BRANCH
+
+    for (const Spill & spill : spills)
+    {
+      // only the counters need resetting; everything past them is ignored
+      MnvBuffers & b = *buf;
+      b.n_tracks = b.n_blobs_id = b.n_mc_trajectories = b.n_clusters_id = b.n_mc_id_digits = b.n_interactions = 0;
+
+      // simulation: the offsets are zero and the times are small, so the reader knows this isn't data
+      b.offsetX = b.offsetY = b.offsetZ = 0;
+      b.ev_trigger_type = 1;
+      b.ev_gl_gate = static_cast<int>(spill.id);
+      b.ev_gps_time_sec = static_cast<int>(spill.time_s);
+      b.ev_gps_time_usec = static_cast<int>(spill.time_ns / 1000);
+      b.ev_run = static_cast<int>(cfg.run);
+      b.ev_sub_run = 0;
+      b.ev_gate = static_cast<int>(spill.id);
+
+      for (const Interaction & ixn : spill.interactions)
+      {
+        if (b.n_interactions >= 200)
+          break;
+        const int intIdx = b.n_interactions++;
+        for (std::size_t axis = 0; axis < 3; axis++)
+          b.mc_int_vtx[intIdx][axis] = ixn.vtx[axis] * 10.;
+        b.mc_int_vtx[intIdx][3] = ixn.t;
+        b.mc_int_edepsimId[intIdx] = static_cast<long long>(ixn.ixnID);
+
+        for (const Particle & part : ixn.particles)
+        {
+          if (b.n_mc_trajectories >= 10000)
+            break;
+          const int traj = b.n_mc_trajectories++;
+          b.mc_traj_trkid[traj] = traj;
+          b.mc_traj_parentid[traj] = part.parentID;
+          b.mc_traj_pdg[traj] = part.pdg;
+          b.mc_traj_edepsim_trkid[traj] = part.trackID;
+          b.mc_traj_edepsim_eventid[traj] = static_cast<long long>(ixn.ixnID);
+          b.mc_traj_npoints[traj] = 2;
+          for (int pt = 0; pt < 5; pt++)
+          {
+            const auto & pos = pt == 0 ? part.start : part.end;
+            b.mc_traj_point_x[traj][pt] = pos[0] * 10.;
+            b.mc_traj_point_y[traj][pt] = pos[1] * 10.;
+            b.mc_traj_point_z[traj][pt] = pos[2] * 10.;
+            b.mc_traj_point_t[traj][pt] = part.t;
+            b.mc_traj_point_px[traj][pt] = pt == 0 ? part.p4[0] * 1000. : 0.;
+            b.mc_traj_point_py[traj][pt] = pt == 0 ? part.p4[1] * 1000. : 0.;
+            b.mc_traj_point_pz[traj][pt] = pt == 0 ? part.p4[2] * 1000. : 0.;
+            b.mc_traj_point_E[traj][pt] = pt == 0 ? part.p4[3] * 1000. : Mass(part.pdg) * 1000.;
+          }
+
+          // MINERvA only sees what leaves ND-LAr through its front or back
+          const bool reachesUpstream = part.end[2] < kMnvUpstreamBack_cm;
+          const bool reachesDownstream = part.end[2] > kMnvDownstreamFront_cm;
+          if (!IsVisible(part.pdg) || !(reachesUpstream || reachesDownstream))
+            continue;
+          const double planeZ_cm = reachesDownstream ? kMnvDownstreamFront_cm : kMnvUpstreamBack_cm;
+          const double dz = part.end[2] - part.start[2];
+          const double fracIn = dz != 0 ? std::clamp((planeZ_cm - part.start[2]) / dz, 0., 1.) : 0.;
+          const double p = std::sqrt(part.p4[0] * part.p4[0] + part.p4[1] * part.p4[1] + part.p4[2] * part.p4[2]);
+          const double visE = (1 - fracIn) * (part.p4[3] - Mass(part.pdg)) * 1000.;
+          b.mc_traj_hit_e[traj] = visE;
+
+          if (IsTrackLike(part.pdg) && b.n_tracks < 100)
+          {
+            const int trk = b.n_tracks++;
+            b.trk_index[trk] = trk;
+            b.trk_type[trk] = 1;
+            b.trk_patrec[trk] = 1;
+            b.trk_time_slice[trk] = intIdx + 1;
+            b.trk_vis_energy[trk] = visE * eSmear(rng);
+            b.trk_theta[trk] = std::acos(std::clamp(part.p4[2] / p, -1., 1.));
+            b.trk_phi[trk] = std::atan2(part.p4[1], part.p4[0]);
+            b.trk_fitMass[trk] = Mass(part.pdg) * 1000.;
+            b.trk_chi2perDof[trk] = 1.;
+
+            // one node per plane (every ~2 cm), up to the reader's limit
+            const int nNodes = std::clamp(static_cast<int>(std::abs(dz) * (1 - fracIn) / 2.) + 2, 2, 300);
+            b.trk_nodes[trk] = nNodes;
+            b.trk_hits[trk] = nNodes;
+            b.trk_dof[trk] = std::max(nNodes - 4, 1);
+            for (int node = 0; node < nNodes; node++)
+            {
+              const double frac = fracIn + (1 - fracIn) * node / (nNodes - 1);
+              b.trk_node_X[trk][node] = (part.start[0] + frac * (part.end[0] - part.start[0])) * 10. + posSmear(rng);
+              b.trk_node_Y[trk][node] = (part.start[1] + frac * (part.end[1] - part.start[1])) * 10. + posSmear(rng);
+              b.trk_node_Z[trk][node] = (part.start[2] + frac * dz) * 10.;
+              b.trk_node_aX[trk][node] = part.p4[0] / part.p4[2];
+              b.trk_node_aY[trk][node] = part.p4[1] / part.p4[2];
+              b.trk_node_qOverP[trk][node] = (part.pdg > 0 ? -1. : 1.) / (p * 1000.);
+              b.trk_node_chi2[trk][node] = 1.;
+              b.trk_node_cluster_idx[trk][node] = AddCluster(b, traj, visE / nNodes);
+              if (b.trk_node_cluster_idx[trk][node] < 0)
+              {
+                // out of room for clusters.  keep the nodes that have them
+                b.trk_nodes[trk] = b.trk_hits[trk] = node;
+                break;
+              }
+            }
+            if (b.trk_nodes[trk] == 0)
+              b.n_tracks--;
+          }
+          else if (!IsTrackLike(part.pdg) && b.n_blobs_id < 1000)
+          {
+            const int blob = b.n_blobs_id++;
+            b.blob_id_idx[blob] = blob;
+            b.blob_id_subdet[blob] = 2;
+            b.blob_id_history[blob] = 0;
+            b.blob_id_patrec[blob] = 1;
+            b.blob_id_e[blob] = visE * eSmear(rng);
+            b.blob_id_time[blob] = part.t;
+            b.blob_id_time_slice[blob] = intIdx + 1;
+            const double startFrac = fracIn;
+            const double midFrac = (1 + fracIn) / 2;
+            b.blob_id_startpoint_x[blob] = (part.start[0] + startFrac * (part.end[0] - part.start[0])) * 10.;
+            b.blob_id_startpoint_y[blob] = (part.start[1] + startFrac * (part.end[1] - part.start[1])) * 10.;
+            b.blob_id_startpoint_z[blob] = (part.start[2] + startFrac * dz) * 10.;
+            b.blob_id_centroid_x[blob] = (part.start[0] + midFrac * (part.end[0] - part.start[0])) * 10.;
+            b.blob_id_centroid_y[blob] = (part.start[1] + midFrac * (part.end[1] - part.start[1])) * 10.;
+            b.blob_id_centroid_z[blob] = (part.start[2] + midFrac * dz) * 10.;
+
+            const int nClus = std::clamp(static_cast<int>(visE / 10.) + 1, 1, 1500);
+            b.blob_id_size[blob] = 0;
+            for (int clusIdx = 0; clusIdx < nClus; clusIdx++)
+            {
+              const int clus = AddCluster(b, traj, visE / nClus);
+              if (clus < 0)
+                break;
+              b.blob_id_clus_idx[blob][b.blob_id_size[blob]++] = clus;
+            }
+          }
+        } // for (part)
+      } // for (ixn)
+
+      tree->Fill();
+    } // for (spill)
+
+    outF.Write();
+    outF.Close();
+  }
+}
@@ -0,0 +1,128 @@
+#include "bench/synth/SyntheticWriters.h"
+
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "TFile.h"
+#include "TTree.h"
+
+namespace cafmaker::synth
+{
+  void WritePandora(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg)
+  {
+    std::mt19937_64 rng(cfg.seed + 4);
+    std::bernoulli_distribution sliceFound(0.9);
+    std::normal_distribution<double> posSmear(0., 0.7);   // cm
+    std::normal_distribution<double> eSmear(1., 0.1);
+    std::uniform_real_distribution<double> completeness(0.7, 1.);
+
+    TFile outF(filename.c_str(), "RECREATE");
+    auto tree = new TTree("LArRecoND", "LArRecoND");   // owned by outF
+
+    int eventId, run, subRun, unixTime, unixTimeUsec, startTime, triggerType;
+    std::vector<int> isShower, sliceId, n3DHits, isPrimary, isRecoPrimary, recoPDG;
+    std::vector<float> startX, startY, startZ, endX, endY, endZ, dirX, dirY, dirZ, energy, pfoCompleteness, nuVtxX, nuVtxY, nuVtxZ;
+    std::vector<long> mcNuId, mcLocalId;
+
+    tree->Branch("event", &eventId);
+    tree->Branch("run", &run);
+    tree->Branch("subRun", &subRun);
+    tree->Branch("unixTime", &unixTime);
+    tree->Branch("unixTimeUsec", &unixTimeUsec);
+    tree->Branch("startTime", &startTime);
+    tree->Branch("triggers", &triggerType);
+    tree->Branch("isShower", &isShower);
+    tree->Branch("sliceId", &sliceId);
+    tree->Branch("startX", &startX);
+    tree->Branch("startY", &startY);
+    tree->Branch("startZ", &startZ);
+    tree->Branch("endX", &endX);
+    tree->Branch("endY", &endY);
+    tree->Branch("endZ", &endZ);
+    tree->Branch("dirX", &dirX);
+    tree->Branch("dirY", &dirY);
+    tree->Branch("dirZ", &dirZ);
+    tree->Branch("energy", &energy);
+    tree->Branch("n3DHits", &n3DHits);
+    tree->Branch("mcNuId", &mcNuId);
+    tree->Branch("mcLocalId", &mcLocalId);
+    tree->Branch("isPrimary", &isPrimary);
+    tree->Branch("completeness", &pfoCompleteness);
+    tree->Branch("nuVtxX", &nuVtxX);
+    tree->Branch("nuVtxY", &nuVtxY);
+    tree->Branch("nuVtxZ", &nuVtxZ);
+    tree->Branch("isRecoPrimary", &isRecoPrimary);
+    tree->Branch("recoPDG", &recoPDG);
+
+    for (const Spill & spill : spills)
+    {
+      eventId = static_cast<int>(spill.id);
+      run = static_cast<int>(cfg.run);
+      subRun = 0;
+      unixTime = static_cast<int>(spill.time_s);
+      unixTimeUsec = static_cast<int>(spill.time_ns / 1000);
+      startTime = 0;
+      triggerType = 1;   // what the MC flow files use
+
+      for (auto * vec : {&isShower, &sliceId, &n3DHits, &isPrimary, &isRecoPrimary, &recoPDG})
+        vec->clear();
+      for (auto * vec : {&startX, &startY, &startZ, &endX, &endY, &endZ, &dirX, &dirY, &dirZ, &energy, &pfoCompleteness, &nuVtxX, &nuVtxY, &nuVtxZ})
+        vec->clear();
+      mcNuId.clear();
+      mcLocalId.clear();
+
+      // one slice per interaction that was found, holding one PFO per visible particle.
+      // the vectors are indexed by PFO, with the slice-level quantities repeated for each
+      int nSlices = 0;
+      for (const Interaction & ixn : spill.interactions)
+      {
+        if (!sliceFound(rng))
+          continue;
+        const int slice = nSlices++;
+        std::array<double, 3> recoVtx{};
+        for (std::size_t axis = 0; axis < 3; axis++)
+          recoVtx[axis] = ixn.vtx[axis] + posSmear(rng);
+
+        for (const Particle & part : ixn.particles)
+        {
+          if (!IsVisible(part.pdg) || part.p4[3] - Mass(part.pdg) < 0.01)
+            continue;
+
+          const double p = std::sqrt(part.p4[0] * part.p4[0] + part.p4[1] * part.p4[1] + part.p4[2] * part.p4[2]);
+          const double length = std::sqrt(std::pow(part.end[0] - part.start[0], 2) + std::pow(part.end[1] - part.start[1], 2)
+                                          + std::pow(part.end[2] - part.start[2], 2));
+          const bool track = IsTrackLike(part.pdg);
+
+          isShower.push_back(!track);
+          sliceId.push_back(slice);
+          startX.push_back(static_cast<float>(part.start[0] + posSmear(rng)));
+          startY.push_back(static_cast<float>(part.start[1] + posSmear(rng)));
+          startZ.push_back(static_cast<float>(part.start[2] + posSmear(rng)));
+          endX.push_back(static_cast<float>(part.end[0] + posSmear(rng)));
+          endY.push_back(static_cast<float>(part.end[1] + posSmear(rng)));
+          endZ.push_back(static_cast<float>(part.end[2] + posSmear(rng)));
+          dirX.push_back(static_cast<float>(part.p4[0] / p));
+          dirY.push_back(static_cast<float>(part.p4[1] / p));
+          dirZ.push_back(static_cast<float>(part.p4[2] / p));
+          energy.push_back(static_cast<float>((part.p4[3] - Mass(part.pdg)) * eSmear(rng)));
+          n3DHits.push_back(static_cast<int>(length * 2.5) + 1);
+          mcNuId.push_back(static_cast<long>(ixn.ixnID));
+          mcLocalId.push_back(part.trackID);
+          isPrimary.push_back(part.primary ? 1 : 0);
+          pfoCompleteness.push_back(static_cast<float>(completeness(rng)));
+          nuVtxX.push_back(static_cast<float>(recoVtx[0]));
+          nuVtxY.push_back(static_cast<float>(recoVtx[1]));
+          nuVtxZ.push_back(static_cast<float>(recoVtx[2]));
+          isRecoPrimary.push_back(part.primary ? 1 : 0);
+          recoPDG.push_back(track ? (std::abs(part.pdg) == 2212 ? 2212 : 13) : 11);
+        } // for (part)
+      } // for (ixn)
+
+      tree->Fill();
+    } // for (spill)
+
+    outF.Write();
+    outF.Close();
+  }
+}
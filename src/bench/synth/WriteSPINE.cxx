@@ -0,0 +1,496 @@
+#include "bench/synth/SyntheticWriters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <type_traits>
+
+#include "H5Cpp.h"
+
+#include "reco/DLP_h5_classes.h"
+#include "util/HDF5Mutex.h"
+
+namespace dlp = cafmaker::types::dlp;
+
+namespace
+{
+  /// The variable-length fields in the DLP structs only hold pointers,
+  /// so whatever they point to has to stay put until the datasets are written
+  class VLStore
+  {
+    public:
+      template <typename T>
+      hvl_t Keep(std::vector<T> contents)
+      {
+        std::deque<std::vector<T>> & pool = Pool<T>();
+        pool.push_back(std::move(contents));
+        return {pool.back().size(), pool.back().empty() ? nullptr : pool.back().data()};
+      }
+
+      char * Keep(std::string str)
+      {
+        fStrings.push_back(std::move(str));
+        return fStrings.back().data();
+      }
+
+    private:
+      template <typename T>
+      std::deque<std::vector<T>> & Pool()
+      {
+        if constexpr (std::is_same_v<T, int64_t>)
+          return fInt64s;
+        else if constexpr (std::is_same_v<T, int32_t>)
+          return fInt32s;
+        else
+          return fFloats;
+      }
+
+      std::deque<std::vector<int64_t>> fInt64s;
+      std::deque<std::vector<int32_t>> fInt32s;
+      std::deque<std::vector<float>>   fFloats;
+      std::deque<std::string>          fStrings;
+  };
+
+  // ---------------------------------------------------------------------
+  /// Resizable and chunked, like the datasets h5py writes
+  template <typename T>
+  void WriteDataset(H5::H5File & file, const std::string & name, const std::vector<T> & rows)
+  {
+    hsize_t dims[1] = {rows.size()};
+    hsize_t maxDims[1] = {H5S_UNLIMITED};
+    H5::DataSpace space(1, dims, maxDims);
+
+    H5::DSetCreatPropList props;
+    hsize_t chunk[1] = {std::max<hsize_t>(1, std::min<hsize_t>(rows.size(), 1024))};
+    props.setChunk(1, chunk);
+
+    H5::CompType type = dlp::BuildCompType<T>();
+    H5::DataSet ds = file.createDataSet(name, type, space, props);
+    if (!rows.empty())
+      ds.write(rows.data(), type);
+  }
+
+  // ---------------------------------------------------------------------
+  /// Region reference to rows [first, first + count) of a dataset (which must already exist)
+  void MakeRegionRef(H5::H5File & file, const std::string & dsName, hsize_t nRows,
+                     hsize_t first, hsize_t count, hdset_reg_ref_t * ref)
+  {
+    H5::DataSpace space(1, &nRows);
+    if (count > 0)
+      space.selectHyperslab(H5S_SELECT_SET, &count, &first);
+    else
+      space.selectNone();
+    file.reference(ref, dsName.c_str(), space, H5R_DATASET_REGION);
+  }
+
+  // ---------------------------------------------------------------------
+  dlp::Pid PidFor(int pdg)
+  {
+    switch (std::abs(pdg))
+    {
+      case 22:   return dlp::Pid::kPhoton;
+      case 11:   return dlp::Pid::kElectron;
+      case 13:   return dlp::Pid::kMuon;
+      case 211:  return dlp::Pid::kPion;
+      case 2212: return dlp::Pid::kProton;
+      case 321:  return dlp::Pid::kKaon;
+      default:   return dlp::Pid::kUnknown;
+    }
+  }
+
+  // ---------------------------------------------------------------------
+  double Distance(const std::array<double, 3> & a, const std::array<double, 3> & b)
+  {
+    return std::sqrt(std::pow(b[0] - a[0], 2) + std::pow(b[1] - a[1], 2) + std::pow(b[2] - a[2], 2));
+  }
+
+  // ---------------------------------------------------------------------
+  template <typename T, typename U, std::size_t N>
+  std::array<T, N> ToArray(const std::array<U, N> & in, double scale = 1.)
+  {
+    std::array<T, N> out{};
+    for (std::size_t idx = 0; idx < N; idx++)
+      out[idx] = static_cast<T>(in[idx] * scale);
+    return out;
+  }
+
+  // ---------------------------------------------------------------------
+  std::array<float, 3> Direction(const cafmaker::synth::Particle & part)
+  {
+    const double p = std::sqrt(std::pow(part.p4[0], 2) + std::pow(part.p4[1], 2) + std::pow(part.p4[2], 2));
+    if (p <= 0)
+      return {0, 0, 1};
+    return {static_cast<float>(part.p4[0] / p), static_cast<float>(part.p4[1] / p), static_cast<float>(part.p4[2] / p)};
+  }
+
+  // ---------------------------------------------------------------------
+  std::string Topology(const std::array<int64_t, 6> & primaryCounts)
+  {
+    static const char * labels[6] = {"g", "e", "mu", "pi", "p", "k"};
+    std::string topo;
+    for (std::size_t pid = 0; pid < primaryCounts.size(); pid++)
+    {
+      if (primaryCounts[pid] > 0)
+        topo += std::to_string(primaryCounts[pid]) + labels[pid];
+    }
+    return topo;
+  }
+}
+
+namespace cafmaker::synth
+{
+  void WriteSPINE(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg)
+  {
+    std::mt19937_64 rng(cfg.seed + 1);
+    std::bernoulli_distribution ixnFound(0.92);
+    std::normal_distribution<double> posSmear(0., 0.5);     // cm
+    std::normal_distribution<double> keSmear(1., 0.08);
+    std::exponential_distribution<double> pe(1 / 50.);
+
+    VLStore store;
+    std::vector<dlp::TrueInteraction> trueIxns;
+    std::vector<dlp::TrueParticle>    trueParts;
+    std::vector<dlp::Interaction>     recoIxns;
+    std::vector<dlp::Particle>        recoParts;
+    std::vector<dlp::Flash>           flashes;
+    std::vector<dlp::RunInfo>         runInfos;
+    std::vector<dlp::Trigger>         triggers;
+
+    // [first, count) for each dataset, for each event
+    struct Ranges
+    {
+      std::size_t trueIxns[2], trueParts[2], recoIxns[2], recoParts[2], flashes[2], runInfo[2], trigger[2];
+    };
+    std::vector<Ranges> eventRanges;
+    eventRanges.reserve(spills.size());
+
+    for (const Spill & spill : spills)
+    {
+      Ranges ranges{};
+      ranges.trueIxns[0] = trueIxns.size();
+      ranges.trueParts[0] = trueParts.size();
+      ranges.recoIxns[0] = recoIxns.size();
+      ranges.recoParts[0] = recoParts.size();
+      ranges.flashes[0] = flashes.size();
+
+      // ids within this event
+      int64_t trueIxnId = 0;
+      int64_t truePartId = 0;
+      int64_t recoIxnId = 0;
+      int64_t recoPartId = 0;
+
+      for (const Interaction & ixn : spill.interactions)
+      {
+        const bool reconstructed = ixnFound(rng);
+        const std::size_t firstTruePart = trueParts.size();
+
+        // one flash per interaction, whether the charge readout found it or not
+        dlp::Flash flash{};
+        flash.id = static_cast<int64_t>(flashes.size() - ranges.flashes[0]);
+        flash.volume_id = static_cast<int64_t>(std::floor((ixn.vtx[0] + 350.) / 100.));
+        flash.time = ixn.t / 1000.;   // us
+        flash.time_width = 0.1;
+        flash.time_abs = flash.time;
+        flash.in_beam_frame = 1;
+        flash.on_beam_time = 1;
+        std::vector<float> pePerCh(48);
+        for (float & chPE : pePerCh)
+          chPE = static_cast<float>(pe(rng));
+        flash.total_pe = std::accumulate(pePerCh.begin(), pePerCh.end(), 0.);
+        flash.fast_to_total = 0.3;
+        flash.pe_per_ch_handle = store.Keep(std::move(pePerCh));
+        flash.center = ToArray<float>(ixn.vtx);
+        flash.width = {30., 30., 30.};
+        flash.units = store.Keep("cm");
+        flashes.push_back(flash);
+
+        // --- truth ---
+        dlp::TrueInteraction trueIxn{};
+        trueIxn.id = trueIxnId++;
+        trueIxn.orig_id = static_cast<int64_t>(ixn.ixnID);
+        trueIxn.interaction_id = trueIxn.id;
+        trueIxn.nu_id = trueIxn.id;
+        trueIxn.is_truth = true;
+        trueIxn.is_contained = true;
+        trueIxn.is_fiducial = true;
+        trueIxn.units = store.Keep("cm");
+        trueIxn.creation_process = store.Keep("primary");
+        trueIxn.pdg_code = ixn.nuPdg;
+        trueIxn.lepton_pdg_code = ixn.particles.front().pdg;
+        trueIxn.lepton_track_id = 0;
+        trueIxn.track_id = -1;
+        trueIxn.target = ixn.targetPdg;
+        trueIxn.nucleon = ixn.hitNucPdg;
+        trueIxn.current_type = ixn.isCC ? dlp::CurrentType::kCC : dlp::CurrentType::kNC;
+        const std::size_t nHadrons = ixn.NPrimaries() - 1;
+        if (nHadrons <= 1)
+        {
+          trueIxn.interaction_mode = dlp::InteractionMode::kQE;
+          trueIxn.interaction_type = ixn.isCC ? dlp::InteractionType::kCCQE : dlp::InteractionType::kNCQE;
+        }
+        else if (nHadrons == 2)
+        {
+          trueIxn.interaction_mode = dlp::InteractionMode::kMEC;
+          trueIxn.interaction_type = dlp::InteractionType::kMEC2p2h;
+        }
+        else
+        {
+          trueIxn.interaction_mode = dlp::InteractionMode::kDIS;
+          trueIxn.interaction_type = ixn.isCC ? dlp::InteractionType::kCCDIS : dlp::InteractionType::kNCDIS;
+        }
+        trueIxn.energy_init = ixn.Enu * 1000.;
+        trueIxn.vertex = ToArray<float>(ixn.vtx);
+        trueIxn.position = trueIxn.vertex;
+        trueIxn.reco_vertex = trueIxn.vertex;
+        trueIxn.momentum = {0, 0, static_cast<float>(ixn.Enu * 1000.)};
+        const Particle & lepton = ixn.particles.front();
+        trueIxn.lepton_p = std::sqrt(std::pow(lepton.p4[0], 2) + std::pow(lepton.p4[1], 2) + std::pow(lepton.p4[2], 2)) * 1000.;
+        trueIxn.theta = trueIxn.lepton_p > 0 ? std::acos(lepton.p4[2] * 1000. / trueIxn.lepton_p) : 0.;
+        trueIxn.energy_transfer = (ixn.Enu - lepton.p4[3]) * 1000.;
+
+        // the particles' ids follow their track ids, offset by the particles of the earlier interactions
+        const int64_t firstTruePartId = truePartId;
+        std::vector<int64_t> truePartIds;
+        for (const Particle & part : ixn.particles)
+        {
+          dlp::TrueParticle truePart{};
+          truePart.id = truePartId++;
+          truePart.interaction_id = trueIxn.id;
+          truePart.orig_interaction_id = trueIxn.orig_id;
+          truePart.nu_id = trueIxn.nu_id;
+          truePart.track_id = part.trackID;
+          truePart.parent_track_id = part.parentID < 0 ? part.trackID : part.parentID;
+          truePart.ancestor_track_id = part.primary ? part.trackID : ixn.particles[part.parentID].trackID;
+          truePart.parent_id = part.primary ? truePart.id : firstTruePartId + part.parentID;
+          truePart.group_id = truePart.id;
+          truePart.gen_id = part.primary ? part.trackID : -1;
+          truePart.is_primary = part.primary;
+          truePart.interaction_primary = part.primary;
+          truePart.group_primary = 1;
+          truePart.pdg_code = part.pdg;
+          truePart.parent_pdg_code = part.primary ? 0 : ixn.particles[part.parentID].pdg;
+          truePart.ancestor_pdg_code = part.primary ? part.pdg : ixn.particles[part.parentID].pdg;
+          truePart.pid = PidFor(part.pdg);
+          truePart.shape = IsTrackLike(part.pdg) ? dlp::Shape::kTrack : dlp::Shape::kShower;
+          truePart.is_truth = true;
+          truePart.is_valid = true;
+          truePart.is_contained = true;
+          truePart.units = store.Keep("cm");
+          truePart.creation_process = store.Keep(part.primary ? "primary" : "eIoni");
+          truePart.parent_creation_process = store.Keep("primary");
+          truePart.ancestor_creation_process = store.Keep("primary");
+          truePart.mass = Mass(part.pdg) * 1000.;
+          truePart.energy_init = part.p4[3] * 1000.;
+          truePart.ke = truePart.energy_init - truePart.mass;
+          truePart.calo_ke = truePart.ke;
+          truePart.csda_ke = truePart.ke;
+          truePart.mcs_ke = truePart.ke;
+          truePart.energy_deposit = IsVisible(part.pdg) ? truePart.ke : 0.;
+          truePart.depositions_sum = static_cast<float>(truePart.energy_deposit);
+          truePart.momentum = ToArray<float>(std::array<double, 3>{part.p4[0], part.p4[1], part.p4[2]}, 1000.);
+          truePart.p = std::sqrt(truePart.momentum[0] * truePart.momentum[0] + truePart.momentum[1] * truePart.momentum[1]
+                                 + truePart.momentum[2] * truePart.momentum[2]);
+          truePart.start_point = ToArray<float>(part.start);
+          truePart.end_point = ToArray<float>(part.end);
+          truePart.position = truePart.start_point;
+          truePart.end_position = truePart.end_point;
+          truePart.first_step = truePart.start_point;
+          truePart.last_step = truePart.end_point;
+          truePart.parent_position = ToArray<float>(part.primary ? part.start : ixn.particles[part.parentID].start);
+          truePart.ancestor_position = truePart.parent_position;
+          truePart.start_dir = Direction(part);
+          truePart.end_dir = truePart.start_dir;
+          truePart.reco_start_dir = truePart.start_dir;
+          truePart.reco_end_dir = truePart.end_dir;
+          truePart.length = Distance(part.start, part.end);
+          truePart.reco_length = truePart.length;
+          truePart.distance_travel = truePart.length;
+          truePart.size = IsVisible(part.pdg) ? static_cast<int64_t>(truePart.length * 2.5) + 1 : 0;
+          truePart.num_voxels = truePart.size;
+          truePart.t = part.t;
+          truePart.end_t = part.t + truePart.length / 30.;
+          truePart.parent_t = part.t;
+          truePart.ancestor_t = part.t;
+
+          std::vector<int64_t> children;
+          for (const Particle & other : ixn.particles)
+          {
+            if (other.parentID == part.trackID)
+              children.push_back(firstTruePartId + other.trackID);
+          }
+          truePart.children_id_handle = store.Keep(std::move(children));
+
+          if (part.primary)
+          {
+            const auto pid = static_cast<int64_t>(truePart.pid);
+            if (pid >= 0)
+            {
+              trueIxn.primary_particle_counts[pid]++;
+              trueIxn.particle_counts[pid]++;
+            }
+          }
+          trueIxn.size += truePart.size;
+          trueIxn.depositions_sum += truePart.depositions_sum;
+
+          truePartIds.push_back(truePart.id);
+          trueParts.push_back(truePart);
+        }
+        trueIxn.num_particles = static_cast<int64_t>(truePartIds.size());
+        trueIxn.particle_ids_handle = store.Keep(std::move(truePartIds));
+        trueIxn.topology = store.Keep(Topology(trueIxn.primary_particle_counts));
+        trueIxn.is_flash_matched = true;
+        trueIxn.flash_ids_handle = store.Keep(std::vector<int32_t>{static_cast<int32_t>(flash.id)});
+        trueIxn.flash_volume_ids_handle = store.Keep(std::vector<int32_t>{static_cast<int32_t>(flash.volume_id)});
+        trueIxn.flash_times_handle = store.Keep(std::vector<int32_t>{static_cast<int32_t>(flash.time)});
+        trueIxn.flash_total_pe = flash.total_pe;
+        trueIxn.flash_hypo_pe = flash.total_pe * 0.95;
+
+        // --- reco ---
+        if (reconstructed)
+        {
+          dlp::Interaction recoIxn{};
+          recoIxn.id = recoIxnId++;
+          recoIxn.units = store.Keep("cm");
+          recoIxn.is_contained = true;
+          recoIxn.is_fiducial = true;
+          recoIxn.is_matched = true;
+          recoIxn.match_ids_handle = store.Keep(std::vector<int64_t>{trueIxn.id});
+          recoIxn.match_overlaps_handle = store.Keep(std::vector<float>{0.9f});
+          for (std::size_t axis = 0; axis < 3; axis++)
+            recoIxn.vertex[axis] = static_cast<float>(ixn.vtx[axis] + posSmear(rng));
+          recoIxn.is_flash_matched = true;
+          recoIxn.flash_ids_handle = store.Keep(std::vector<int32_t>{static_cast<int32_t>(flash.id)});
+          recoIxn.flash_volume_ids_handle = store.Keep(std::vector<int32_t>{static_cast<int32_t>(flash.volume_id)});
+          recoIxn.flash_times_handle = store.Keep(std::vector<int32_t>{static_cast<int32_t>(flash.time)});
+          recoIxn.flash_total_pe = flash.total_pe;
+          recoIxn.flash_hypo_pe = flash.total_pe * 0.95;
+
+          std::vector<int64_t> recoPartIds;
+          std::vector<int64_t> trueIxnMatches;
+          for (std::size_t partIdx = 0; partIdx < ixn.particles.size(); partIdx++)
+          {
+            const Particle & part = ixn.particles[partIdx];
+            dlp::TrueParticle & truePart = trueParts[firstTruePart + partIdx];
+            if (!IsVisible(part.pdg) || truePart.ke < 10.)   // below threshold
+              continue;
+
+            dlp::Particle recoPart{};
+            recoPart.id = recoPartId++;
+            recoPart.interaction_id = recoIxn.id;
+            recoPart.units = store.Keep("cm");
+            recoPart.pid = truePart.pid;
+            recoPart.shape = truePart.shape;
+            recoPart.pdg_code = truePart.pdg_code;
+            recoPart.is_primary = part.primary;
+            recoPart.is_valid = true;
+            recoPart.is_contained = true;
+            recoPart.is_matched = true;
+            recoPart.match_ids_handle = store.Keep(std::vector<int64_t>{truePart.id});
+            recoPart.match_overlaps_handle = store.Keep(std::vector<float>{0.95f});
+            for (std::size_t axis = 0; axis < 3; axis++)
+            {
+              recoPart.start_point[axis] = static_cast<float>(part.start[axis] + posSmear(rng));
+              recoPart.end_point[axis] = static_cast<float>(part.end[axis] + posSmear(rng));
+            }
+            recoPart.start_dir = truePart.start_dir;
+            recoPart.end_dir = truePart.end_dir;
+            recoPart.length = static_cast<float>(truePart.length);
+            recoPart.mass = truePart.mass;
+            recoPart.calo_ke = truePart.ke * keSmear(rng);
+            recoPart.csda_ke = truePart.ke * keSmear(rng);
+            recoPart.mcs_ke = truePart.ke * keSmear(rng);
+            recoPart.ke = recoPart.shape == dlp::Shape::kTrack ? recoPart.csda_ke : recoPart.calo_ke;
+            recoPart.momentum = truePart.momentum;
+            recoPart.p = truePart.p;
+            recoPart.size = truePart.size;
+            recoPart.depositions_sum = truePart.depositions_sum;
+            const auto pid = static_cast<int64_t>(recoPart.pid);
+            if (pid >= 0)
+              recoPart.pid_scores[pid] = 0.9f;
+            recoPart.primary_scores = part.primary ? std::array<float, 2>{0.1f, 0.9f} : std::array<float, 2>{0.9f, 0.1f};
+
+            truePart.is_matched = true;
+            truePart.match_ids_handle = store.Keep(std::vector<int64_t>{recoPart.id});
+            truePart.match_overlaps_handle = store.Keep(std::vector<float>{0.95f});
+
+            if (part.primary && pid >= 0)
+              recoIxn.primary_particle_counts[pid]++;
+            if (pid >= 0)
+              recoIxn.particle_counts[pid]++;
+            recoIxn.size += recoPart.size;
+            recoIxn.depositions_sum += recoPart.depositions_sum;
+
+            recoPartIds.push_back(recoPart.id);
+            recoParts.push_back(recoPart);
+          }
+          recoIxn.num_particles = static_cast<int64_t>(recoPartIds.size());
+          recoIxn.particle_ids_handle = store.Keep(std::move(recoPartIds));
+          recoIxn.topology = store.Keep(Topology(recoIxn.primary_particle_counts));
+
+          trueIxn.is_matched = true;
+          trueIxn.match_ids_handle = store.Keep(std::vector<int64_t>{recoIxn.id});
+          trueIxn.match_overlaps_handle = store.Keep(std::vector<float>{0.9f});
+
+          recoIxns.push_back(recoIxn);
+        } // if (reconstructed)
+
+        trueIxns.push_back(trueIxn);
+      } // for (ixn)
+
+      runInfos.push_back({cfg.run, 0, spill.id});
+      ranges.runInfo[0] = runInfos.size() - 1;
+      ranges.runInfo[1] = 1;
+
+      dlp::Trigger trigger{};
+      trigger.id = spill.id;
+      trigger.type = 1;   // what the MC flow files use
+      trigger.time_s = static_cast<int64_t>(spill.time_s);
+      trigger.time_ns = spill.time_ns;
+      trigger.beam_time_s = trigger.time_s;
+      trigger.beam_time_ns = trigger.time_ns;
+      triggers.push_back(trigger);
+      ranges.trigger[0] = triggers.size() - 1;
+      ranges.trigger[1] = 1;
+
+      ranges.trueIxns[1] = trueIxns.size() - ranges.trueIxns[0];
+      ranges.trueParts[1] = trueParts.size() - ranges.trueParts[0];
+      ranges.recoIxns[1] = recoIxns.size() - ranges.recoIxns[0];
+      ranges.recoParts[1] = recoParts.size() - ranges.recoParts[0];
+      ranges.flashes[1] = flashes.size() - ranges.flashes[0];
+      eventRanges.push_back(ranges);
+    } // for (spill)
+
+    // --- write it all out ---
+    // the dataset names are the ones MLNDLArRecoBranchFiller asks for
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+    H5::H5File file(filename, H5F_ACC_TRUNC);
+    WriteDataset(file, "truth_interactions", trueIxns);
+    WriteDataset(file, "truth_particles", trueParts);
+    WriteDataset(file, "reco_interactions", recoIxns);
+    WriteDataset(file, "reco_particles", recoParts);
+    WriteDataset(file, "flashes", flashes);
+    WriteDataset(file, "run_info", runInfos);
+    WriteDataset(file, "trigger", triggers);
+
+    // the references for products we don't make are left null.  nothing in makeCAF reads them
+    std::vector<dlp::Event> events(eventRanges.size());
+    for (std::size_t evtIdx = 0; evtIdx < eventRanges.size(); evtIdx++)
+    {
+      const Ranges & ranges = eventRanges[evtIdx];
+      dlp::Event & evt = events[evtIdx];
+      MakeRegionRef(file, "truth_interactions", trueIxns.size(), ranges.trueIxns[0], ranges.trueIxns[1], &evt.truth_interactions);
+      MakeRegionRef(file, "truth_particles", trueParts.size(), ranges.trueParts[0], ranges.trueParts[1], &evt.truth_particles);
+      MakeRegionRef(file, "reco_interactions", recoIxns.size(), ranges.recoIxns[0], ranges.recoIxns[1], &evt.reco_interactions);
+      MakeRegionRef(file, "reco_particles", recoParts.size(), ranges.recoParts[0], ranges.recoParts[1], &evt.reco_particles);
+      MakeRegionRef(file, "flashes", flashes.size(), ranges.flashes[0], ranges.flashes[1], &evt.flashes);
+      MakeRegionRef(file, "run_info", runInfos.size(), ranges.runInfo[0], ranges.runInfo[1], &evt.run_info);
+      MakeRegionRef(file, "trigger", triggers.size(), ranges.trigger[0], ranges.trigger[1], &evt.trigger);
+    }
+    WriteDataset(file, "events", events);
+    file.close();
+  }
+}
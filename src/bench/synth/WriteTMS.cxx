@@ -0,0 +1,169 @@
+#include "bench/synth/SyntheticWriters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+
+#include "TFile.h"
+#include "TTree.h"
+
+namespace
+{
+  // TMS sits downstream of ND-LAr.  in mm, which is what the TMS reco uses
+  const double kTMSFront_mm = 11362.;
+  const double kTMSBack_mm  = 18314.;
+
+  /// Same shapes as the arrays TMSRecoBranchFiller reads into
+  struct TMSBuffers
+  {
+    int   EventNo;
+    int   SliceNo;
+    int   SpillNo;
+    int   RunNo;
+    int   nTracks;
+    int   nHits[10];
+    float Length[10];
+    float Momentum[10];
+    float EnergyRange[10];
+    float EnergyDeposit[10];
+    float TrackHitPos[100][200][4];
+    float StartPos[10][3];
+    float KalmanPos[100][200][4];
+    float EndPos[10][3];
+    float StartDirection[10][3];
+    float EndDirection[10][3];
+
+    double TMSStartTime[10];
+
+    int RecoTrackPrimaryParticleVtxId[10];
+    int RecoTrackPrimaryParticleIndex[10];
+    int RecoTrackSecondaryParticleIndex[10];
+  };
+}
+
+namespace cafmaker::synth
+{
+  void WriteTMS(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg)
+  {
+    std::mt19937_64 rng(cfg.seed + 2);
+    std::normal_distribution<double> posSmear(0., 20.);   // mm
+    std::normal_distribution<double> pSmear(1., 0.05);
+
+    TFile outF(filename.c_str(), "RECREATE");
+    // the file owns the trees and deletes them when it's closed
+    auto recoTree = new TTree("Reco_Tree", "Reco_Tree");
+    auto lcTree = new TTree("Line_Candidates", "Line_Candidates");
+    auto truthTree = new TTree("Truth_Info", "Truth_Info");
+
+    // too big for the stack
+    auto buf = std::make_unique<TMSBuffers>();
+
+    recoTree->Branch("EventNo", &buf->EventNo, "EventNo/I");
+    recoTree->Branch("SliceNo", &buf->SliceNo, "SliceNo/I");
+    recoTree->Branch("SpillNo", &buf->SpillNo, "SpillNo/I");
+    recoTree->Branch("RunNo", &buf->RunNo, "RunNo/I");
+    recoTree->Branch("nTracks", &buf->nTracks, "nTracks/I");
+    recoTree->Branch("nHits", buf->nHits, "nHits[10]/I");
+    recoTree->Branch("Length", buf->Length, "Length[10]/F");
+    recoTree->Branch("Momentum", buf->Momentum, "Momentum[10]/F");
+    recoTree->Branch("EnergyRange", buf->EnergyRange, "EnergyRange[10]/F");
+    recoTree->Branch("EnergyDeposit", buf->EnergyDeposit, "EnergyDeposit[10]/F");
+    recoTree->Branch("TrackHitPos", buf->TrackHitPos, "TrackHitPos[100][200][4]/F");
+    recoTree->Branch("StartPos", buf->StartPos, "StartPos[10][3]/F");
+    recoTree->Branch("KalmanPos", buf->KalmanPos, "KalmanPos[100][200][4]/F");
+    recoTree->Branch("EndPos", buf->EndPos, "EndPos[10][3]/F");
+    recoTree->Branch("StartDirection", buf->StartDirection, "StartDirection[10][3]/F");
+    recoTree->Branch("EndDirection", buf->EndDirection, "EndDirection[10][3]/F");
+
+    lcTree->Branch("TMSStartTime", buf->TMSStartTime, "TMSStartTime[10]/D");
+
+    truthTree->Branch("RecoTrackPrimaryParticleVtxId", buf->RecoTrackPrimaryParticleVtxId, "RecoTrackPrimaryParticleVtxId[10]/I");
+    truthTree->Branch("RecoTrackPrimaryParticleIndex", buf->RecoTrackPrimaryParticleIndex, "RecoTrackPrimaryParticleIndex[10]/I");
+    truthTree->Branch("RecoTrackSecondaryParticleIndex", buf->RecoTrackSecondaryParticleIndex, "RecoTrackSecondaryParticleIndex[10]/I");
+
+    int eventNo = 0;
+    for (const Spill & spill : spills)
+    {
+      // one 'slice' per interaction.  the reader makes a trigger out of each run of entries with the same SpillNo,
+      // so spills without any interactions still need an (empty) entry
+      const std::size_t nSlices = std::max<std::size_t>(spill.interactions.size(), 1);
+      for (std::size_t sliceIdx = 0; sliceIdx < nSlices; sliceIdx++)
+      {
+        *buf = TMSBuffers{};
+        buf->EventNo = eventNo++;
+        buf->SliceNo = static_cast<int>(sliceIdx);
+        buf->SpillNo = static_cast<int>(spill.id);
+        buf->RunNo = static_cast<int>(cfg.run);
+
+        if (sliceIdx < spill.interactions.size())
+        {
+          const Interaction & ixn = spill.interactions[sliceIdx];
+          for (const Particle & part : ixn.particles)
+          {
+            // only muons and pions going forward make it out of the LAr and into the TMS
+            if (buf->nTracks >= 10 || !part.primary || (std::abs(part.pdg) != 13 && std::abs(part.pdg) != 211) || part.p4[2] <= 0)
+              continue;
+            const double endZ_mm = part.end[2] * 10.;
+            if (endZ_mm < kTMSFront_mm)
+              continue;
+
+            const double p = std::sqrt(part.p4[0] * part.p4[0] + part.p4[1] * part.p4[1] + part.p4[2] * part.p4[2]);
+            const std::array<double, 3> dir{part.p4[0] / p, part.p4[1] / p, part.p4[2] / p};
+
+            // follow the particle from the TMS front face to wherever it stops (or leaves out the back)
+            const double toFront = (kTMSFront_mm - part.start[2] * 10.) / dir[2];
+            const double toEnd = (std::min(endZ_mm, kTMSBack_mm) - part.start[2] * 10.) / dir[2];
+            std::array<double, 3> start{}, end{};
+            for (std::size_t axis = 0; axis < 3; axis++)
+            {
+              start[axis] = part.start[axis] * 10. + toFront * dir[axis];
+              end[axis] = part.start[axis] * 10. + toEnd * dir[axis];
+            }
+
+            const int trk = buf->nTracks++;
+            const int nHits = std::min(200, static_cast<int>((end[2] - start[2]) / 65.) + 2);   // one hit per plane
+            buf->nHits[trk] = nHits;
+            for (int hit = 0; hit < nHits; hit++)
+            {
+              const double frac = nHits > 1 ? static_cast<double>(hit) / (nHits - 1) : 0.;
+              for (std::size_t axis = 0; axis < 3; axis++)
+              {
+                const double pos = start[axis] + frac * (end[axis] - start[axis]);
+                buf->TrackHitPos[trk][hit][axis] = static_cast<float>(pos + (axis < 2 ? posSmear(rng) : 0.));
+                buf->KalmanPos[trk][hit][axis] = static_cast<float>(pos);
+              }
+              buf->TrackHitPos[trk][hit][3] = static_cast<float>(ixn.t);
+              buf->KalmanPos[trk][hit][3] = static_cast<float>(ixn.t);
+            }
+
+            const double length_mm = toEnd - toFront;
+            buf->Length[trk] = static_cast<float>(length_mm * 1.4);   // areal density, g/cm^2 * 10 (the reader divides by 10)
+            buf->Momentum[trk] = static_cast<float>(p * 1000. * pSmear(rng));
+            buf->EnergyRange[trk] = static_cast<float>(part.p4[3] * 1000. * pSmear(rng));
+            buf->EnergyDeposit[trk] = static_cast<float>(length_mm * 0.2);
+            for (std::size_t axis = 0; axis < 3; axis++)
+            {
+              buf->StartPos[trk][axis] = static_cast<float>(start[axis]);
+              buf->EndPos[trk][axis] = static_cast<float>(end[axis]);
+              buf->StartDirection[trk][axis] = static_cast<float>(dir[axis]);
+              buf->EndDirection[trk][axis] = static_cast<float>(dir[axis]);
+            }
+            buf->TMSStartTime[trk] = ixn.t;
+
+            buf->RecoTrackPrimaryParticleVtxId[trk] = static_cast<int>(ixn.evtNum);
+            buf->RecoTrackPrimaryParticleIndex[trk] = part.trackID;
+            buf->RecoTrackSecondaryParticleIndex[trk] = -1;
+          } // for (part)
+        }
+
+        recoTree->Fill();
+        lcTree->Fill();
+        truthTree->Fill();
+      } // for (sliceIdx)
+    } // for (spill)
+
+    outF.Write();
+    outF.Close();
+  }
+}
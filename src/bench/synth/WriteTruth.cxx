@@ -0,0 +1,169 @@
+#include "bench/synth/SyntheticWriters.h"
+
+#include <cmath>
+#include <memory>
+
+#include "TDatabasePDG.h"
+#include "TFile.h"
+#include "TLorentzVector.h"
+#include "TTree.h"
+
+#include "Framework/Conventions/Units.h"
+#include "Framework/EventGen/EventRecord.h"
+#include "Framework/GHEP/GHepStatus.h"
+#include "Framework/Interaction/Interaction.h"
+#include "Framework/Ntuple/NtpMCFormat.h"
+#include "Framework/Ntuple/NtpWriter.h"
+
+#include "TG4Event.h"
+
+namespace
+{
+  const double kArgonMass = 37.2155;   // GeV
+
+  // ---------------------------------------------------------------------
+  std::string ParticleName(int pdg)
+  {
+    const TParticlePDG * particle = TDatabasePDG::Instance()->GetParticle(pdg);
+    return particle ? particle->GetName() : std::to_string(pdg);
+  }
+
+  // ---------------------------------------------------------------------
+  TLorentzVector ToMeV(const std::array<double, 4> & p4_GeV)
+  {
+    return {p4_GeV[0] * 1000., p4_GeV[1] * 1000., p4_GeV[2] * 1000., p4_GeV[3] * 1000.};
+  }
+
+  // ---------------------------------------------------------------------
+  /// Position in mm and time in ns, as edep-sim stores them
+  TLorentzVector ToEdepSimPos(const std::array<double, 3> & pos_cm, double t)
+  {
+    return {pos_cm[0] * 10., pos_cm[1] * 10., pos_cm[2] * 10., t};
+  }
+}
+
+namespace cafmaker::synth
+{
+  // ---------------------------------------------------------------------
+  void WriteGHEP(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg)
+  {
+    // the run number goes into the tree header, which is where TruthMatcher looks for it
+    genie::NtpWriter writer(genie::kNFGHEP, cfg.run);
+    writer.CustomizeFilename(filename);
+    writer.Initialize();
+
+    for (const Spill & spill : spills)
+    {
+      for (const Interaction & ixn : spill.interactions)
+      {
+        const bool fewHadrons = ixn.NPrimaries() <= 2;
+        genie::Interaction * summary = nullptr;
+        if (ixn.isCC)
+          summary = fewHadrons ? genie::Interaction::QELCC(ixn.targetPdg, ixn.hitNucPdg, ixn.nuPdg, ixn.Enu)
+                               : genie::Interaction::DISCC(ixn.targetPdg, ixn.hitNucPdg, ixn.nuPdg, ixn.Enu);
+        else
+          summary = fewHadrons ? genie::Interaction::QELNC(ixn.targetPdg, ixn.hitNucPdg, ixn.nuPdg, ixn.Enu)
+                               : genie::Interaction::DISNC(ixn.targetPdg, ixn.hitNucPdg, ixn.nuPdg, ixn.Enu);
+
+        genie::EventRecord rec;
+        rec.AttachSummary(summary);   // the record owns it now
+
+        // GENIE works in m, not cm
+        const TLorentzVector vtx(ixn.vtx[0] / 100., ixn.vtx[1] / 100., ixn.vtx[2] / 100., 0.);
+        rec.SetVertex(vtx);
+
+        // the usual GHEP layout: probe, nucleus, struck nucleon, then the final state.
+        // TruthMatcher numbers the stable final-state particles in order to match them to the edep-sim track IDs
+        const int hitNucIdx = 2;
+        rec.AddParticle(ixn.nuPdg, genie::kIStInitialState, -1, -1, -1, -1, TLorentzVector(0, 0, ixn.Enu, ixn.Enu), vtx);
+        rec.AddParticle(ixn.targetPdg, genie::kIStInitialState, -1, -1, -1, -1, TLorentzVector(0, 0, 0, kArgonMass), vtx);
+        rec.AddParticle(ixn.hitNucPdg, genie::kIStNucleonTarget, 1, -1, -1, -1, TLorentzVector(0, 0, 0, Mass(ixn.hitNucPdg)), vtx);
+        for (const Particle & part : ixn.particles)
+        {
+          if (!part.primary)
+            continue;
+          const int mother = part.trackID == 0 ? 0 : hitNucIdx;   // the lepton comes from the neutrino
+          rec.AddParticle(part.pdg, genie::kIStStableFinalState, mother, -1, -1, -1,
+                          TLorentzVector(part.p4[0], part.p4[1], part.p4[2], part.p4[3]), vtx);
+        }
+
+        rec.SetXSec(1e-38 * genie::units::cm2);
+        rec.SetWeight(1.);
+
+        writer.AddEventRecord(static_cast<int>(ixn.evtNum), &rec);
+      } // for (ixn)
+    } // for (spill)
+
+    writer.Save();
+  }
+
+  // ---------------------------------------------------------------------
+  void WriteEdepSim(const std::string & filename, const std::vector<Spill> & spills, const Config & cfg)
+  {
+    TFile outF(filename.c_str(), "RECREATE");
+    auto tree = new TTree("EDepSimEvents", "Energy Deposition for Simulated Events");   // owned by outF
+
+    auto event = std::make_unique<TG4Event>();
+    TG4Event * eventPtr = event.get();
+    tree->Branch("Event", &eventPtr);
+
+    for (const Spill & spill : spills)
+    {
+      for (const Interaction & ixn : spill.interactions)
+      {
+        // TruthMatcher finds this event again by RunId * 1e6 + EventId
+        event->RunId = static_cast<int>(cfg.run);
+        event->EventId = static_cast<int>(ixn.evtNum);
+        event->Primaries.clear();
+        event->Trajectories.clear();
+        event->SegmentDetectors.clear();
+
+        TG4PrimaryVertex vertex;
+        vertex.Position = ToEdepSimPos(ixn.vtx, ixn.t);
+        vertex.GeneratorName = "GENIE";
+        vertex.Reaction = ixn.isCC ? "CC" : "NC";
+        vertex.InteractionNumber = static_cast<int>(ixn.evtNum);
+
+        // the trajectories are indexed by track ID, which is how TruthMatcher looks them up
+        for (const Particle & part : ixn.particles)
+        {
+          if (part.primary)
+          {
+            TG4PrimaryParticle primary;
+            primary.TrackId = part.trackID;
+            primary.Name = ParticleName(part.pdg);
+            primary.PDGCode = part.pdg;
+            primary.Momentum = ToMeV(part.p4);
+            vertex.Particles.push_back(std::move(primary));
+          }
+
+          TG4Trajectory traj;
+          traj.TrackId = part.trackID;
+          traj.ParentId = part.parentID;
+          traj.Name = ParticleName(part.pdg);
+          traj.PDGCode = part.pdg;
+          traj.InitialMomentum = ToMeV(part.p4);
+
+          TG4TrajectoryPoint first;
+          first.Position = ToEdepSimPos(part.start, part.t);
+          first.Momentum = traj.InitialMomentum.Vect();
+          traj.Points.push_back(first);
+
+          TG4TrajectoryPoint last;
+          last.Position = ToEdepSimPos(part.end, part.t + std::sqrt(std::pow(part.end[0] - part.start[0], 2)
+                                                                    + std::pow(part.end[1] - part.start[1], 2)
+                                                                    + std::pow(part.end[2] - part.start[2], 2)) / 30.);
+          traj.Points.push_back(last);
+
+          event->Trajectories.push_back(std::move(traj));
+        } // for (part)
+        event->Primaries.push_back(std::move(vertex));
+
+        tree->Fill();
+      } // for (ixn)
+    } // for (spill)
+
+    outF.Write();
+    outF.Close();
+  }
+}
@@ -0,0 +1,247 @@
+#include "output/HDF5FlatCAFWriter.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TLeafC.h"
+#include "TTree.h"
+
+#include "duneanaobj/StandardRecord/Flat/FlatRecord.h"
+
+#include "CAF.h"
+#include "util/HDF5Mutex.h"
+#include "util/Logger.h"
+
+namespace
+{
+  // ------------------------------------------------------------
+  /// HDF5 type for the values in a leaf, or null if it's one we don't write
+  const H5::PredType * H5Type(const TLeaf & leaf)
+  {
+    // strings are Char_t leaves too
+    if (leaf.IsA() == TLeafC::Class())
+      return nullptr;
+
+    static const std::map<std::string, const H5::PredType *> kTypes
+    {
+      {"Bool_t",    &H5::PredType::NATIVE_UINT8},
+      {"Char_t",    &H5::PredType::NATIVE_INT8},
+      {"UChar_t",   &H5::PredType::NATIVE_UINT8},
+      {"Short_t",   &H5::PredType::NATIVE_INT16},
+      {"UShort_t",  &H5::PredType::NATIVE_UINT16},
+      {"Int_t",     &H5::PredType::NATIVE_INT32},
+      {"UInt_t",    &H5::PredType::NATIVE_UINT32},
+      {"Long_t",    &H5::PredType::NATIVE_LONG},
+      {"ULong_t",   &H5::PredType::NATIVE_ULONG},
+      {"Long64_t",  &H5::PredType::NATIVE_INT64},
+      {"ULong64_t", &H5::PredType::NATIVE_UINT64},
+      {"Float_t",   &H5::PredType::NATIVE_FLOAT},
+      {"Double_t",  &H5::PredType::NATIVE_DOUBLE},
+    };
+
+    auto it = kTypes.find(leaf.GetTypeName());
+    return it != kTypes.end() ? it->second : nullptr;
+  }
+}
+
+namespace cafmaker
+{
+  // ------------------------------------------------------------
+  HDF5FlatCAFWriter::HDF5FlatCAFWriter(const std::string & filename, unsigned int chunkSize, unsigned int compressionLevel,
+                                       const BranchSelection & branches)
+    : fChunkSize(std::max(chunkSize, 1u)), fCompressionLevel(std::min(compressionLevel, 9u))
+  {
+    // the tree lives in memory only, and not in whichever output file was opened last
+    fTree = std::make_unique<TTree>("cafTree", "cafTree");
+    fTree->SetDirectory(nullptr);
+    fRecord = std::make_unique<flat::Flat<caf::StandardRecord>>(fTree.get(), "rec", "", nullptr);
+    ApplyBranchSelection(*fTree, branches);
+
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+
+    fFile = std::make_unique<H5::H5File>(filename, H5F_ACC_TRUNC);
+    H5::Group recGroup = fFile->createGroup("cafTree");
+    H5::Group offsetsGroup = fFile->createGroup("offsets");
+    const H5::StrType strType(H5::PredType::C_S1, H5T_VARIABLE);
+
+    std::size_t nSkipped = 0;
+    for (TObject * obj : *fTree->GetListOfLeaves())
+    {
+      auto leaf = static_cast<TLeaf*>(obj);
+      if (leaf->GetBranch()->TestBit(TBranch::kDoNotProcess))
+        continue;
+
+      const H5::PredType * type = H5Type(*leaf);
+      if (!type)
+      {
+        nSkipped++;
+        continue;
+      }
+
+      LeafColumn & leafCol = fLeafColumns.emplace_back();
+      leafCol.leaf = leaf;
+      leafCol.col = MakeColumn(recGroup, leaf->GetBranch()->GetName(), *type);
+
+      if (leaf->GetLenStatic() > 1)
+      {
+        const int valuesPerEntry = leaf->GetLenStatic();
+        leafCol.col.ds.createAttribute("values_per_entry", H5::PredType::NATIVE_INT, H5::DataSpace(H5S_SCALAR))
+                      .write(H5::PredType::NATIVE_INT, &valuesPerEntry);
+      }
+
+      TLeaf * countLeaf = leaf->GetLeafCount();
+      if (!countLeaf)
+        continue;
+
+      if (fOffsets.find(countLeaf) == fOffsets.end())
+      {
+        OffsetsColumn offsets;
+        offsets.countLeaf = countLeaf;
+        offsets.col = MakeColumn(offsetsGroup, countLeaf->GetBranch()->GetName(), H5::PredType::NATIVE_ULLONG);
+        Append(offsets.col, &offsets.total, sizeof(offsets.total));  // record 0 starts at 0
+        fOffsets.emplace(countLeaf, std::move(offsets));
+      }
+      leafCol.col.ds.createAttribute("offsets", strType, H5::DataSpace(H5S_SCALAR))
+                    .write(strType, std::string("/offsets/") + countLeaf->GetBranch()->GetName());
+    }
+
+    if (nSkipped > 0)
+      LOG_S("HDF5FlatCAFWriter").INFO() << "Not writing " << nSkipped << " string (or otherwise unsupported) leaves of the flat record to " << filename << "\n";
+  }
+
+  // ------------------------------------------------------------
+  HDF5FlatCAFWriter::~HDF5FlatCAFWriter()
+  {
+    // the datasets and the file close themselves as they go away, which has to happen under the lock too
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+    fLeafColumns.clear();
+    fOffsets.clear();
+    fFile.reset();
+  }
+
+  // ------------------------------------------------------------
+  HDF5FlatCAFWriter::Column HDF5FlatCAFWriter::MakeColumn(H5::Group & group, const std::string & name, const H5::PredType & type)
+  {
+    Column col;
+    col.type = &type;
+    col.typeSize = type.getSize();
+
+    // starts empty, grows as the chunks are written
+    const hsize_t dims[1] = {0};
+    const hsize_t maxDims[1] = {H5S_UNLIMITED};
+    const hsize_t chunk[1] = {fChunkSize};
+    H5::DSetCreatPropList props;
+    props.setChunk(1, chunk);
+    if (fCompressionLevel > 0)
+    {
+      // byte-shuffling first makes the slowly-varying high bytes of numeric columns compress much better
+      props.setShuffle();
+      props.setDeflate(fCompressionLevel);
+    }
+
+    col.ds = group.createDataSet(name, type, H5::DataSpace(1, dims, maxDims), props);
+    col.buffer.reserve(static_cast<std::size_t>(fChunkSize) * col.typeSize);
+
+    return col;
+  }
+
+  // ------------------------------------------------------------
+  void HDF5FlatCAFWriter::Append(Column & col, const void * values, std::size_t nBytes)
+  {
+    if (nBytes == 0)
+      return;
+    const char * bytes = static_cast<const char *>(values);
+    col.buffer.insert(col.buffer.end(), bytes, bytes + nBytes);
+  }
+
+  // ------------------------------------------------------------
+  void HDF5FlatCAFWriter::Flush(Column & col)
+  {
+    const hsize_t n = col.buffer.size() / col.typeSize;
+    if (n == 0)
+      return;
+
+    const hsize_t newSize[1] = {col.nWritten + n};
+    col.ds.extend(newSize);
+
+    H5::DataSpace fileSpace = col.ds.getSpace();
+    const hsize_t start[1] = {col.nWritten};
+    const hsize_t count[1] = {n};
+    fileSpace.selectHyperslab(H5S_SELECT_SET, count, start);
+    H5::DataSpace memSpace(1, count);
+    col.ds.write(col.buffer.data(), *col.type, memSpace, fileSpace);
+
+    col.nWritten += n;
+    col.buffer.clear();
+  }
+
+  // ------------------------------------------------------------
+  void HDF5FlatCAFWriter::FlushAll()
+  {
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+
+    for (LeafColumn & leafCol : fLeafColumns)
+      Flush(leafCol.col);
+    for (auto & offsetsPair : fOffsets)
+      Flush(offsetsPair.second.col);
+
+    fNBuffered = 0;
+  }
+
+  // ------------------------------------------------------------
+  void HDF5FlatCAFWriter::Fill(CAF & caf)
+  {
+    fRecord->Clear();
+    fRecord->Fill(caf.sr);
+
+    // the tree is never filled, so the leaves' own GetLen() (which checks against the maximum filled so far)
+    // can't be used.  the counts are read straight from the count leaves instead
+    for (LeafColumn & leafCol : fLeafColumns)
+    {
+      std::size_t n = leafCol.leaf->GetLenStatic();
+      if (const TLeaf * countLeaf = leafCol.leaf->GetLeafCount())
+        n *= static_cast<std::size_t>(countLeaf->GetValue());
+      Append(leafCol.col, leafCol.leaf->GetValuePointer(), n * leafCol.col.typeSize);
+    }
+
+    for (auto & offsetsPair : fOffsets)
+    {
+      OffsetsColumn & offsets = offsetsPair.second;
+      offsets.total += static_cast<unsigned long long>(offsets.countLeaf->GetValue());
+      Append(offsets.col, &offsets.total, sizeof(offsets.total));
+    }
+
+    if (++fNBuffered >= fChunkSize)
+      FlushAll();
+  }
+
+  // ------------------------------------------------------------
+  void HDF5FlatCAFWriter::FillPOT(CAF & caf)
+  {
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+
+    H5::Group meta = fFile->createGroup("meta");
+    auto writeScalar = [&meta](const std::string & name, const H5::PredType & type, const void * value)
+    {
+      meta.createDataSet(name, type, H5::DataSpace(H5S_SCALAR)).write(value, type);
+    };
+    writeScalar("pot", H5::PredType::NATIVE_DOUBLE, &caf.pot);
+    writeScalar("run", H5::PredType::NATIVE_INT, &caf.meta_run);
+    writeScalar("subrun", H5::PredType::NATIVE_INT, &caf.meta_subrun);
+    writeScalar("version", H5::PredType::NATIVE_INT, &caf.version);
+  }
+
+  // ------------------------------------------------------------
+  void HDF5FlatCAFWriter::Write()
+  {
+    FlushAll();
+
+    // the file isn't really closed until every dataset in it is
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+    fLeafColumns.clear();
+    fOffsets.clear();
+    fFile->close();
+  }
+}
@@ -0,0 +1,97 @@
+/// \file HDF5FlatCAFWriter.h
+///
+///  Write the flat CAF record as HDF5 column datasets.
+///
+
+#ifndef ND_CAFMAKER_HDF5FLATCAFWRITER_H
+#define ND_CAFMAKER_HDF5FLATCAFWRITER_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "H5Cpp.h"
+
+#include "duneanaobj/StandardRecord/Flat/FwdDeclare.h"
+
+#include "output/ICAFWriter.h"
+#include "util/TreeIO.h"
+
+class TLeaf;
+class TTree;
+
+namespace cafmaker
+{
+  /// Writes every leaf of the flat CAF record to a 1-D, chunked, compressed dataset of its own
+  /// in the group '/cafTree', named like the flat CAF's branch ("rec.mc.nu.E" etc.).
+  /// The datasets can be read straight into NumPy (or awkward-array) without ROOT.
+  ///
+  /// Columns holding one value per record have one row per record.  Columns whose length varies
+  /// from record to record (the flat CAF's variable-size arrays) are concatenated across records.
+  /// They carry an 'offsets' attribute naming a dataset in '/offsets', with one more row than there are records,
+  /// whose entries i and i+1 bound record i's part of the column.  Columns that share a length share the offsets.
+  /// The nested levels are indexed within a record by the flat CAF's own '..idx' and '..length' columns.
+  ///
+  /// The metadata (POT, run, subrun, version) are written to scalar datasets in '/meta'.
+  /// Leaves with more than one value per entry (fixed-size arrays) say how many in a 'values_per_entry' attribute;
+  /// the offsets and the '..idx' columns count entries, not values.
+  /// String leaves, and the branches `branches` leaves out, aren't written.
+  class HDF5FlatCAFWriter : public ICAFWriter
+  {
+    public:
+      /// \param chunkSize         Rows per HDF5 chunk.  Values are buffered and written this many records at a time
+      /// \param compressionLevel  gzip level (0-9).  0 doesn't compress
+      HDF5FlatCAFWriter(const std::string & filename, unsigned int chunkSize = 4096, unsigned int compressionLevel = 4,
+                        const BranchSelection & branches = {});
+      ~HDF5FlatCAFWriter() override;
+
+      void Fill(CAF & caf) override;
+      void FillPOT(CAF & caf) override;
+      void Write() override;
+
+    private:
+      /// Values waiting to be appended to one dataset
+      struct Column
+      {
+        H5::DataSet ds;
+        const H5::PredType * type = nullptr;
+        std::size_t typeSize = 0;    ///< bytes per value
+        hsize_t nWritten = 0;
+        std::vector<char> buffer;
+      };
+
+      /// A leaf of the flat record and where its values go
+      struct LeafColumn
+      {
+        TLeaf * leaf = nullptr;
+        Column col;
+      };
+
+      /// Where each record starts in the columns sized by one count leaf
+      struct OffsetsColumn
+      {
+        TLeaf * countLeaf = nullptr;
+        unsigned long long total = 0;
+        Column col;
+      };
+
+      Column MakeColumn(H5::Group & group, const std::string & name, const H5::PredType & type);
+      void Append(Column & col, const void * values, std::size_t nBytes);
+      void Flush(Column & col);
+      void FlushAll();
+
+      std::unique_ptr<TTree> fTree;    ///< never filled or written.  it just lays out the flat record's leaves
+      std::unique_ptr<flat::Flat<caf::StandardRecord>> fRecord;
+
+      std::unique_ptr<H5::H5File> fFile;
+      unsigned int fChunkSize;
+      unsigned int fCompressionLevel;
+
+      std::vector<LeafColumn> fLeafColumns;
+      std::map<const TLeaf*, OffsetsColumn> fOffsets;
+      unsigned int fNBuffered = 0;
+  };
+}
+
+#endif //ND_CAFMAKER_HDF5FLATCAFWRITER_H
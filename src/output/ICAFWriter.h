@@ -0,0 +1,54 @@
+/// \file ICAFWriter.h
+///
+///  Base class for the backends that write the CAF's records to disk.
+///
+
+#ifndef ND_CAFMAKER_ICAFWRITER_H
+#define ND_CAFMAKER_ICAFWRITER_H
+
+class CAF;
+
+namespace genie
+{
+  class NtpMCEventRecord;
+}
+
+namespace cafmaker
+{
+  /// One output of the CAF.
+  ///
+  /// `CAF` owns the records (`sr`, `srglobal`, the metadata, ...) and hands itself
+  /// to each of its writers at each step.  Writers may bind to the addresses of those
+  /// members when they're made, so a writer mustn't outlive the `CAF` it was made for.
+  /// `srglobal` is already filled when a writer is made, so it should be stored then.
+  class ICAFWriter
+  {
+    public:
+      virtual ~ICAFWriter() = default;
+
+      /// Store the current `caf.sr` (and the geometric efficiency throws that go with it)
+      virtual void Fill(CAF & caf) = 0;
+
+      /// Store the metadata (POT, run, subrun, version).  Called once, at the end of the job
+      virtual void FillPOT(CAF & caf) = 0;
+
+      /// Store a GENIE record
+      ///
+      /// \return  Index of the stored record in this writer's output, or -1 if it doesn't store GENIE records
+      virtual int StoreGENIEEvent(CAF &, const genie::NtpMCEventRecord *) { return -1; }
+
+      /// Store where a GENIE record is in the input .ghep files (`caf.genieRef`), instead of the record itself
+      ///
+      /// \return  Index of the stored reference in this writer's output, or -1 if it doesn't store them
+      virtual int StoreGENIERef(CAF &) { return -1; }
+
+      /// Save everything stored so far, so that it survives if the job is killed before Write().
+      /// Outputs that can't be recovered that way needn't do anything: `makeCAF --resume` remakes them anyway
+      virtual void Checkpoint() {}
+
+      /// Flush everything to disk and close the output.  Nothing may be filled afterwards
+      virtual void Write() = 0;
+  };
+}
+
+#endif //ND_CAFMAKER_ICAFWRITER_H
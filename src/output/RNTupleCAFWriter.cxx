@@ -0,0 +1,149 @@
+#include "output/RNTupleCAFWriter.h"
+
+#include <stdexcept>
+
+#include "CAF.h"
+
+#ifdef ENABLE_RNTUPLE
+
+#include <utility>
+
+#include "RVersion.h"
+#include "TFile.h"
+
+// the writer and its options moved to headers of their own (and out of ROOT::Experimental) over the ROOT 6.3x series
+#include <ROOT/RNTuple.hxx>
+#include <ROOT/RNTupleModel.hxx>
+#if __has_include(<ROOT/RNTupleWriter.hxx>)
+#include <ROOT/RNTupleWriter.hxx>
+#endif
+#if __has_include(<ROOT/RNTupleWriteOptions.hxx>)
+#include <ROOT/RNTupleWriteOptions.hxx>
+#else
+#include <ROOT/RNTupleOptions.hxx>
+#endif
+
+namespace
+{
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6, 36, 0)
+  namespace rnt = ROOT;
+#else
+  namespace rnt = ROOT::Experimental;
+#endif
+
+  using GeoEffThrows = std::vector< std::vector < std::vector < uint64_t > > >;
+}
+
+namespace cafmaker
+{
+  struct RNTupleCAFWriter::Impl
+  {
+    std::unique_ptr<TFile> file;
+    rnt::RNTupleWriteOptions options;
+
+    // the fields' values.  owned by the models, which are owned by the writers
+    std::shared_ptr<caf::StandardRecord> rec;
+    std::shared_ptr<GeoEffThrows>        geoEffThrowResults;
+    std::shared_ptr<double>              pot;
+    std::shared_ptr<int>                 run;
+    std::shared_ptr<int>                 subrun;
+    std::shared_ptr<int>                 version;
+
+    std::unique_ptr<rnt::RNTupleWriter> recWriter;
+    std::unique_ptr<rnt::RNTupleWriter> mvaWriter;
+    std::unique_ptr<rnt::RNTupleWriter> metaWriter;
+  };
+
+  // ------------------------------------------------------------
+  RNTupleCAFWriter::RNTupleCAFWriter(CAF & caf, const std::string & filename, int compression)
+    : fImpl(std::make_unique<Impl>())
+  {
+    fImpl->file.reset(TFile::Open(filename.c_str(), "RECREATE"));
+    if (!fImpl->file || fImpl->file->IsZombie())
+      throw std::runtime_error("RNTupleCAFWriter: couldn't open output file: " + filename);
+
+    if (compression >= 0)
+      fImpl->options.SetCompression(compression);
+
+    auto recModel = rnt::RNTupleModel::Create();
+    fImpl->rec = recModel->MakeField<caf::StandardRecord>("rec");
+    fImpl->recWriter = rnt::RNTupleWriter::Append(std::move(recModel), "cafTree", *fImpl->file, fImpl->options);
+
+    auto mvaModel = rnt::RNTupleModel::Create();
+    fImpl->geoEffThrowResults = mvaModel->MakeField<GeoEffThrows>("geoEffThrowResults");
+    fImpl->mvaWriter = rnt::RNTupleWriter::Append(std::move(mvaModel), "mvaTree", *fImpl->file, fImpl->options);
+
+    auto metaModel = rnt::RNTupleModel::Create();
+    fImpl->pot = metaModel->MakeField<double>("pot");
+    fImpl->run = metaModel->MakeField<int>("run");
+    fImpl->subrun = metaModel->MakeField<int>("subrun");
+    fImpl->version = metaModel->MakeField<int>("version");
+    fImpl->metaWriter = rnt::RNTupleWriter::Append(std::move(metaModel), "meta", *fImpl->file, fImpl->options);
+
+    // the global record is complete by now, so it's written (and its writer committed) straight away
+    auto globalModel = rnt::RNTupleModel::Create();
+    auto global = globalModel->MakeField<caf::SRGlobal>("global");
+    auto globalWriter = rnt::RNTupleWriter::Append(std::move(globalModel), "globalTree", *fImpl->file, fImpl->options);
+    *global = caf.srglobal;
+    globalWriter->Fill();
+  }
+
+  // ------------------------------------------------------------
+  RNTupleCAFWriter::~RNTupleCAFWriter() = default;
+
+  // ------------------------------------------------------------
+  void RNTupleCAFWriter::Fill(CAF & caf)
+  {
+    // the models own the objects their fields are read from.
+    // swapping the records in and back out again is a handful of pointer moves, where copying would be a deep copy
+    std::swap(*fImpl->rec, caf.sr);
+    std::swap(*fImpl->geoEffThrowResults, *caf.geoEffThrowResults);
+    fImpl->recWriter->Fill();
+    fImpl->mvaWriter->Fill();
+    std::swap(*fImpl->rec, caf.sr);
+    std::swap(*fImpl->geoEffThrowResults, *caf.geoEffThrowResults);
+  }
+
+  // ------------------------------------------------------------
+  void RNTupleCAFWriter::FillPOT(CAF & caf)
+  {
+    *fImpl->pot = caf.pot;
+    *fImpl->run = caf.meta_run;
+    *fImpl->subrun = caf.meta_subrun;
+    *fImpl->version = caf.version;
+    fImpl->metaWriter->Fill();
+  }
+
+  // ------------------------------------------------------------
+  void RNTupleCAFWriter::Write()
+  {
+    // the writers commit their last clusters and their footers when they go away
+    fImpl->recWriter.reset();
+    fImpl->mvaWriter.reset();
+    fImpl->metaWriter.reset();
+
+    fImpl->file->Close();
+  }
+}
+
+#else // ENABLE_RNTUPLE
+
+namespace cafmaker
+{
+  struct RNTupleCAFWriter::Impl {};
+
+  RNTupleCAFWriter::RNTupleCAFWriter(CAF &, const std::string &, int)
+  {
+    throw std::runtime_error("RNTuple output was not enabled in your build: it needs ROOT built with RNTuple support (6.28 or newer).\n"
+                             " Either remove 'rntuple' from `nd_cafmaker.CAFMakerSettings.OutputFormats` in your FCL\n"
+                             " or rebuild ND_CAFMaker against such a ROOT");
+  }
+
+  RNTupleCAFWriter::~RNTupleCAFWriter() = default;
+
+  void RNTupleCAFWriter::Fill(CAF &) {}
+  void RNTupleCAFWriter::FillPOT(CAF &) {}
+  void RNTupleCAFWriter::Write() {}
+}
+
+#endif // ENABLE_RNTUPLE
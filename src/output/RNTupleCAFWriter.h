@@ -0,0 +1,44 @@
+/// \file RNTupleCAFWriter.h
+///
+///  Write the CAF as ROOT RNTuples.
+///
+
+#ifndef ND_CAFMAKER_RNTUPLECAFWRITER_H
+#define ND_CAFMAKER_RNTUPLECAFWRITER_H
+
+#include <memory>
+#include <string>
+
+#include "output/ICAFWriter.h"
+
+namespace cafmaker
+{
+  /// Writes 'cafTree', 'globalTree', 'mvaTree' and 'meta' as RNTuples, with the same field names as
+  /// the branches in the structured CAF.  RNTuple stores every leaf of the StandardRecord in a column
+  /// of its own, so this one output serves as both the structured and the flat CAF.
+  ///
+  /// Pages are compressed on ROOT's implicit-MT pool when it's enabled (see `OutputCompressionThreads`).
+  ///
+  /// GENIE records aren't stored: RNTuple can't hold TObject-derived classes like genie::NtpMCEventRecord.
+  /// Write the TTree CAF alongside if they're needed.
+  ///
+  /// Needs ROOT built with RNTuple support (6.28 or newer); throws when constructed otherwise.
+  class RNTupleCAFWriter : public ICAFWriter
+  {
+    public:
+      /// \param compression  ROOT compression settings (see `CompressionSettings()`).  < 0 keeps RNTuple's default
+      RNTupleCAFWriter(CAF & caf, const std::string & filename, int compression = -1);
+      ~RNTupleCAFWriter() override;
+
+      void Fill(CAF & caf) override;
+      void FillPOT(CAF & caf) override;
+      void Write() override;
+
+    private:
+      // keeps the RNTuple headers (and their ROOT version dependence) out of here
+      struct Impl;
+      std::unique_ptr<Impl> fImpl;
+  };
+}
+
+#endif //ND_CAFMAKER_RNTUPLECAFWRITER_H
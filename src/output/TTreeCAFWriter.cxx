@@ -0,0 +1,238 @@
+#include "output/TTreeCAFWriter.h"
+
+#include "Compression.h"
+#include "TFile.h"
+#include "TTree.h"
+
+#include "duneanaobj/StandardRecord/Flat/FlatRecord.h"
+
+#include "CAF.h"
+#include "util/Logger.h"
+#include "util/OutputFilename.h"
+
+namespace cafmaker
+{
+  // ------------------------------------------------------------
+  TTreeCAFWriter::TTreeCAFWriter(CAF & caf, const std::string & filename, bool makeStructuredCAF, bool makeFlatCAF,
+                                 bool storeGENIE, const CAFTreeIO & treeIO)
+    : fTreeIO(treeIO)
+  {
+    if (makeStructuredCAF)
+    {
+      fCAFFile = new TFile( filename.c_str(), "RECREATE" );
+
+      // initialize standard record bits
+      fCAFSR = new TTree("cafTree", "cafTree");
+      fCAFSR->Branch("rec", "caf::StandardRecord", &caf.sr);
+      ApplyTreeIOSettings(*fCAFSR, fTreeIO.cafTree);
+      ApplyBranchSelection(*fCAFSR, fTreeIO.branches);
+
+      BookAuxTrees(caf, fCAFSRGlobal, fCAFMVA, fCAFPOT, fGENIE, storeGENIE);
+    }
+
+    if (makeFlatCAF)
+    {
+      // LZ4 is the fastest format to decompress. I get 3x faster loading with
+      // this compared to the default, and the files are only slightly larger.
+      const int flatCompression = fTreeIO.flatCAFTree.compression >= 0 ? fTreeIO.flatCAFTree.compression
+                                                                       : ROOT::CompressionSettings(ROOT::kLZ4, 1);
+      fFlatCAFFile = new TFile( util::CompanionFilename(filename, ".flat.root").c_str(),
+                                "RECREATE", "", flatCompression);
+
+      fFlatCAFTree = new TTree("cafTree", "cafTree");
+
+      fFlatCAFRecord = new flat::Flat<caf::StandardRecord>(fFlatCAFTree, "rec", "", 0);
+      ApplyTreeIOSettings(*fFlatCAFTree, fTreeIO.flatCAFTree);
+      ApplyBranchSelection(*fFlatCAFTree, fTreeIO.branches);
+
+      // the flat file gets its own copies of the other trees, filled alongside the ones in the structured file,
+      // so nothing has to be copied over (or held in memory) at the end of the job
+      BookAuxTrees(caf, fFlatGlobalTree, fFlatMVATree, fFlatPOTTree, fFlatGENIETree, storeGENIE);
+    }
+
+    for (auto tree : {fCAFSRGlobal, fFlatGlobalTree})
+    {
+      if (tree)
+        tree->Fill();
+    }
+  }
+
+  // ------------------------------------------------------------
+  void TTreeCAFWriter::BookAuxTrees(CAF & caf, TTree *& globalTree, TTree *& mvaTree, TTree *& potTree, TTree *& genieTree,
+                                    bool storeGENIE)
+  {
+    // the trees go into whichever file was opened most recently
+    globalTree = new TTree("globalTree", "globalTree");
+    potTree = new TTree( "meta", "meta" );
+
+    TBranch* br = globalTree->Branch("global", &caf.srglobal);
+    if(!br) abort();
+
+    // the MVA tree has nothing else in it, so it's left out entirely if its branch is
+    if (fTreeIO.branches.Keep("geoEffThrowResults"))
+    {
+      mvaTree = new TTree("mvaTree", "mvaTree");
+      mvaTree->Branch("geoEffThrowResults", &caf.geoEffThrowResults);
+      ApplyTreeIOSettings(*mvaTree, fTreeIO.mvaTree);
+    }
+
+    potTree->Branch( "pot", &caf.pot, "pot/D" );
+    potTree->Branch( "run", &caf.meta_run, "run/I" );
+    potTree->Branch( "subrun", &caf.meta_subrun, "subrun/I" );
+    potTree->Branch( "version", &caf.version, "version/I" );
+
+    // the references point into the input files, so the list of them is what makes them usable
+    if (storeGENIE && caf.GENIEStorageMode() == GENIEStorage::kReference)
+    {
+      potTree->Branch( "ghep_files", &caf.ghepFiles );
+
+      genieTree = new TTree( "genieRef", "genieRef" );
+      genieTree->Branch( "file", &caf.genieRef.file, "file/I" );
+      genieTree->Branch( "run", &caf.genieRef.run, "run/l" );
+      genieTree->Branch( "entry", &caf.genieRef.entry, "entry/i" );
+      ApplyTreeIOSettings(*genieTree, fTreeIO.genieTree);
+    }
+    // initialize the GENIE record
+    else if (storeGENIE)
+    {
+      genieTree = new TTree( "genieEvt", "genieEvt" );
+      genieTree->Branch( "genie_record", &caf.mcrec );
+      ApplyTreeIOSettings(*genieTree, fTreeIO.genieTree);
+    }
+  }
+
+  // ------------------------------------------------------------
+  void TTreeCAFWriter::Fill(CAF & caf)
+  {
+    if(fCAFSR)
+    {
+      fCAFSR->Fill();
+      MaybeAutoTuneBaskets(*fCAFSR, fTreeIO.cafTree);
+    }
+    for (auto tree : {fCAFMVA, fFlatMVATree})
+    {
+      if (!tree)
+        continue;
+      tree->Fill();
+      MaybeAutoTuneBaskets(*tree, fTreeIO.mvaTree);
+    }
+
+    if(fFlatCAFFile){
+      fFlatCAFRecord->Clear();
+      fFlatCAFRecord->Fill(caf.sr);
+      fFlatCAFTree->Fill();
+      MaybeAutoTuneBaskets(*fFlatCAFTree, fTreeIO.flatCAFTree);
+    }
+  }
+
+  // ------------------------------------------------------------
+  void TTreeCAFWriter::FillPOT(CAF &)
+  {
+    for (auto tree : {fCAFPOT, fFlatPOTTree})
+    {
+      if (tree)
+        tree->Fill();
+    }
+  }
+
+  // ------------------------------------------------------------
+  int TTreeCAFWriter::StoreGENIEEvent(CAF & caf, const genie::NtpMCEventRecord * evtIn)
+  {
+    // if the GENIE tree is not already pointing to the given address, we can make it happen,
+    // but it will slow things down
+    if (evtIn != caf.mcrec)
+    {
+      // might be better to throw an exception or something,
+      // since the *user* can't do anything about this,
+      // but all the throw-ing and catch-ing will slow us down even more
+      static bool warned = false;
+      if (!warned)
+      {
+        LOG_S("TTreeCAFWriter::StoreGENIEEvent()").WARNING() << "Repeatedly reassigning the target pointer for output GENIE tree will result in significant performance degredation\n";
+        warned = true;
+      }
+    }
+
+    TTree * stored = nullptr;
+    for (auto tree : {fGENIE, fFlatGENIETree})
+    {
+      if (!tree)
+        continue;
+
+      if (evtIn != caf.mcrec)
+        tree->SetBranchAddress("genie_record", &evtIn);
+
+      tree->Fill();
+      MaybeAutoTuneBaskets(*tree, fTreeIO.genieTree);
+
+      // now reset the tree
+      if (evtIn != caf.mcrec)
+        tree->SetBranchAddress("genie_record", &caf.mcrec);
+
+      if (!stored)
+        stored = tree;
+    }
+
+    return stored ? stored->GetEntries()-1 : -1;
+  }
+
+  // ------------------------------------------------------------
+  int TTreeCAFWriter::StoreGENIERef(CAF & caf)
+  {
+    if (caf.GENIEStorageMode() != GENIEStorage::kReference)
+      return -1;
+
+    TTree * stored = nullptr;
+    for (auto tree : {fGENIE, fFlatGENIETree})
+    {
+      if (!tree)
+        continue;
+
+      tree->Fill();
+      MaybeAutoTuneBaskets(*tree, fTreeIO.genieTree);
+      if (!stored)
+        stored = tree;
+    }
+
+    return stored ? stored->GetEntries()-1 : -1;
+  }
+
+  // ------------------------------------------------------------
+  void TTreeCAFWriter::Checkpoint()
+  {
+    // flushing the baskets and then the tree headers (and the file's list of keys, "SaveSelf")
+    // leaves files that can be read, up to this point, however the job ends
+    for (auto tree : {fCAFSR, fCAFSRGlobal, fCAFMVA, fCAFPOT, fGENIE,
+                      fFlatCAFTree, fFlatGlobalTree, fFlatMVATree, fFlatPOTTree, fFlatGENIETree})
+    {
+      if (tree)
+        tree->AutoSave("SaveSelf;FlushBaskets");
+    }
+  }
+
+  // ------------------------------------------------------------
+  void TTreeCAFWriter::Write()
+  {
+    // every tree was filled directly into its own file,
+    // so all that's left is to flush out the last baskets and the tree headers
+    if(fFlatCAFFile){
+      fFlatCAFFile->cd();
+      for (auto tree : {fFlatCAFTree, fFlatGlobalTree, fFlatMVATree, fFlatPOTTree, fFlatGENIETree })
+      {
+        if (tree)
+          tree->Write();
+      }
+      fFlatCAFFile->Close();
+    }
+
+    if(fCAFFile){
+      fCAFFile->cd();
+      for (auto tree : {fCAFSR, fCAFSRGlobal, fCAFMVA, fCAFPOT, fGENIE })
+      {
+        if (tree)
+          tree->Write();
+      }
+      fCAFFile->Close();
+    }
+  }
+}
@@ -0,0 +1,66 @@
+/// \file TTreeCAFWriter.h
+///
+///  Write the CAF as ROOT TTrees: the structured CAF and/or the flat CAF.
+///
+
+#ifndef ND_CAFMAKER_TTREECAFWRITER_H
+#define ND_CAFMAKER_TTREECAFWRITER_H
+
+#include <string>
+
+#include "duneanaobj/StandardRecord/Flat/FwdDeclare.h"
+
+#include "output/ICAFWriter.h"
+#include "util/TreeIO.h"
+
+class TFile;
+class TTree;
+
+namespace cafmaker
+{
+  /// The default output: 'cafTree', 'globalTree', 'mvaTree', 'meta' and (optionally) 'genieEvt' or 'genieRef'
+  /// in the structured CAF file, with the same set of trees (but a flattened 'cafTree')
+  /// in the flat CAF file next to it.
+  class TTreeCAFWriter : public ICAFWriter
+  {
+    public:
+      /// The flat CAF, if requested, is written next to `filename`, with '.root' replaced by '.flat.root'.
+      /// A CAF that isn't requested isn't filled at all, so it costs nothing
+      TTreeCAFWriter(CAF & caf, const std::string & filename, bool makeStructuredCAF, bool makeFlatCAF, bool storeGENIE,
+                     const CAFTreeIO & treeIO = {});
+
+      void Fill(CAF & caf) override;
+      void FillPOT(CAF & caf) override;
+      int StoreGENIEEvent(CAF & caf, const genie::NtpMCEventRecord * evtIn) override;
+      int StoreGENIERef(CAF & caf) override;
+      void Checkpoint() override;
+      void Write() override;
+
+    private:
+      /// Make the global, MVA, metadata and (optionally) GENIE trees in the current directory
+      void BookAuxTrees(CAF & caf, TTree *& globalTree, TTree *& mvaTree, TTree *& potTree, TTree *& genieTree, bool storeGENIE);
+
+      CAFTreeIO fTreeIO;
+
+      // these are null if the structured CAF isn't being made
+      TFile * fCAFFile     = nullptr;
+      TTree * fCAFSR       = nullptr;
+      TTree * fCAFSRGlobal = nullptr;
+      TTree * fCAFMVA      = nullptr;
+      TTree * fCAFPOT      = nullptr;
+      TTree * fGENIE       = nullptr;   ///< 'genieEvt', or 'genieRef' if only references are stored
+
+      // and these if the flat one isn't
+      TFile * fFlatCAFFile                             = nullptr;
+      TTree * fFlatCAFTree                             = nullptr;
+      flat::Flat<caf::StandardRecord>* fFlatCAFRecord  = nullptr;
+
+      // copies of the trees above that go in the flat file.  they're filled alongside the originals
+      TTree * fFlatGlobalTree                          = nullptr;
+      TTree * fFlatMVATree                             = nullptr;
+      TTree * fFlatPOTTree                             = nullptr;
+      TTree * fFlatGENIETree                           = nullptr;
+  };
+}
+
+#endif //ND_CAFMAKER_TTREECAFWRITER_H
@@ -7,6 +7,7 @@
 #define ND_CAFMAKER_IRECOBRANCHFILLER_H
 
 #include <deque>
+#include <memory>
 #include <stdexcept>
 
 #include "fwd.h"
@@ -73,9 +74,23 @@ namespace cafmaker
       virtual bool IsBeamTrigger(int) const { return false; }
 
 
+      /// \brief Rough estimate of the work needed to fill a trigger (in arbitrary units)
+      ///
+      /// Used to balance the trigger groups between shards, so it should be cheap to compute.
+      /// By default every trigger counts the same.
+      virtual double EstimateCost(const Trigger &) const { return 1.; }
+
       /// What type of IRecoBranchFiller is this?
       virtual RecoFillerType  FillerType() const = 0;
 
+      /// \brief Make an independent filler over the same input
+      ///
+      /// The clone has its own file handles and read buffers, so it can fill triggers
+      /// on a different thread than the original.  State that is read-only once built
+      /// (the trigger list and the trigger-to-entry map) is shared rather than copied,
+      /// so GetTriggers() should be called on the original before cloning it.
+      virtual std::unique_ptr<IRecoBranchFiller> Clone() const = 0;
+
     protected:
       /// Actual implementation of reco branch filling.  Derived classes should override this.
       virtual void _FillRecoBranches(const Trigger &trigger,
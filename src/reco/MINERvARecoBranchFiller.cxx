@@ -1,5 +1,7 @@
 #include "MINERvARecoBranchFiller.h"
 
+#include "util/SRPool.h"
+
 namespace cafmaker
 {
 
@@ -13,9 +15,7 @@ namespace cafmaker
 
 
   MINERvARecoBranchFiller::MINERvARecoBranchFiller(const std::string &minervaRecoFilename, float X_offset, float Y_offset, float Z_offset)
-  : IRecoBranchFiller("MINERvA"),
-    fTriggers(),
-    fLastTriggerReqd(fTriggers.end())
+  : IRecoBranchFiller("MINERvA")
   {
     fMnvRecoFile = new TFile(minervaRecoFilename.c_str(), "READ");
     if (!fMnvRecoFile->IsZombie()) {
@@ -207,6 +207,17 @@ namespace cafmaker
 
   }
 
+  // ------------------------------------------------------------------------------
+  std::unique_ptr<IRecoBranchFiller> MINERvARecoBranchFiller::Clone() const
+  {
+    // for MC the offsets are read from the file, so the ones passed here are ignored
+    auto clone = std::make_unique<MINERvARecoBranchFiller>(fMnvRecoFile->GetName(), offsetX, offsetY, offsetZ);
+    clone->SetLogThrehsold(LOG.GetThreshold());
+    clone->fTriggerIndex = fTriggerIndex;
+    return clone;
+  }
+
+  // ------------------------------------------------------------------------------
   // here we copy all the MINERvA reco into the SRMINERvA branch of the StandardRecord object.
   void MINERvARecoBranchFiller::_FillRecoBranches(const Trigger &trigger,
                                                 caf::StandardRecord &sr,
@@ -214,22 +225,19 @@ namespace cafmaker
                                                 const TruthMatcher *truthMatch) const
   {
 
-    // figure out where in our list of triggers this event index is.
-    // we should always be looking forwards, since we expect to be traversing in that direction
-    auto it_start = (fLastTriggerReqd == fTriggers.end()) ? fTriggers.cbegin() : fLastTriggerReqd;
-    auto itTrig = std::find(it_start, fTriggers.cend(), trigger);
-    if (itTrig == fTriggers.end())
+    // figure out where in our list of triggers this event index is
+    long int idx = fTriggerIndex->Position(trigger);
+    if (idx < 0)
     {
       LOG.FATAL() << "Reco branch filler '" << GetName() << "' could not find trigger with evtID == " << trigger.evtID << "!  Abort.\n";
       abort();
     }
-    std::size_t idx = std::distance(fTriggers.cbegin(), itTrig);
 
     LOG.VERBOSE() << "    Reco branch filler '" << GetName() << "', trigger.evtID == " << trigger.evtID << ", internal evt idx = " << idx << ".\n";
 
 
     // Get nth entry from tree
-    MnvRecoTree->GetEntry(fEntryMap[idx]);  
+    MnvRecoTree->GetEntry(fTriggerIndex->EntryAt(static_cast<std::size_t>(idx)));
     
     //Fill MINERvA specific info in the meta branch
     sr.meta.minerva.enabled = true;
@@ -273,7 +281,7 @@ namespace cafmaker
     for (int i = 0; i < n_tracks; ++i) {
 
       int my_slice = trk_time_slice[i];
-      caf::SRTrack my_track;
+      caf::SRTrack my_track = SRPool<caf::SRTrack>::Acquire();
 
       // Save first and last hit in track
       // MINERvA Reco info is saved in mm whereas CAFs use cm as default -> do conversion here
@@ -295,7 +303,7 @@ namespace cafmaker
 
       //Associates the truth particle to the track
       FindTruthTrack(sr, my_track,i, truthMatch);
-      track_map[my_slice].push_back(my_track);
+      track_map[my_slice].push_back(std::move(my_track));
       //Find the largest reconstructed time slice
       if (max_slice < my_slice) max_slice = my_slice;
     }
@@ -309,7 +317,7 @@ namespace cafmaker
     for (int i = 0; i < n_blobs_id; ++i) 
     {
       int my_slice = blob_id_time_slice[i];
-      caf::SRShower my_shower;
+      caf::SRShower my_shower = SRPool<caf::SRShower>::Acquire();
 
       // Save first and last hit in track
       // MINERvA Reco info is saved in mm whereas CAFs use CM as default -> do conversion here
@@ -337,7 +345,7 @@ namespace cafmaker
       //Associates the truth particle to the shower
       FindTruthShower(sr, my_shower,i, truthMatch);
       //Fill the shower map
-      shower_map[my_slice].push_back(my_shower);
+      shower_map[my_slice].push_back(std::move(my_shower));
       //Find the largest reconstructed time slice
       if (max_slice < my_slice) max_slice = my_slice;
     }
@@ -549,12 +557,11 @@ namespace cafmaker
 
     //Do Trigger Map For consistency with the other branch fillers.
 
-    int iTrigger = 0;
-
-    if (fTriggers.empty())
+    if (!fTriggerIndex)
     {
       LOG.DEBUG() << "Loading triggers with type " << triggerType << " within branch filler '" << GetName() << "' from " << MnvRecoTree->GetEntries() << " MINERvA Tree:\n";
-      fTriggers.reserve(MnvRecoTree->GetEntries());
+      auto index = std::make_shared<TriggerIndex>();
+      index->reserve(static_cast<std::size_t>(MnvRecoTree->GetEntries()));
       unsigned long int t0_minerva;
       MnvRecoTree->GetEntry(0);
       t0_minerva = ev_gps_time_sec;
@@ -569,12 +576,7 @@ namespace cafmaker
           continue;
         }
         
-        fEntryMap[iTrigger] = entry;
-        iTrigger+=1;
-
-        fTriggers.emplace_back();
-
-        Trigger & trig = fTriggers.back();
+        Trigger trig;
 
         trig.evtID = Long_t(ev_gl_gate);
 
@@ -594,14 +596,15 @@ namespace cafmaker
                       << ", triggerTime_s=" << trig.triggerTime_s
                       << ", triggerTime_ns=" << trig.triggerTime_ns
                       << "\n";
-
+        index->Add(trig, entry);
       }
-      fLastTriggerReqd = fTriggers.end();  // since we just modified the list, any iterators have been invalidated
+      fTriggerIndex = std::move(index);
     }
 
-    for (const Trigger & trigger : fTriggers)
+    const std::vector<Trigger> & trigList = fTriggerIndex->Triggers();
+    for (const Trigger & trigger : trigList)
     {
-      if (triggerType < 0 || triggerType == fTriggers.back().triggerType)
+      if (triggerType < 0 || triggerType == trigList.back().triggerType)
         triggers.push_back(trigger);
     }
 
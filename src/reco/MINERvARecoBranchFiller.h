@@ -12,6 +12,7 @@
 
 // The virtual base class
 #include "reco/IRecoBranchFiller.h"
+#include "reco/TriggerIndex.h"
 #include "truth/FillTruth.h"
 
 // File handlers from ROOT
@@ -42,6 +43,7 @@ namespace cafmaker
 
       RecoFillerType FillerType() const override { return RecoFillerType::BaseReco; }
 
+      std::unique_ptr<IRecoBranchFiller> Clone() const override;
 
       ~MINERvARecoBranchFiller();
 
@@ -149,9 +151,7 @@ namespace cafmaker
 
 
       bool is_data;
-      mutable std::vector<cafmaker::Trigger> fTriggers;
-      mutable decltype(fTriggers)::const_iterator  fLastTriggerReqd;    ///< the last trigger requested using _FillRecoBranches()
-      mutable std::map<int,int> fEntryMap; //Map of the filtered trigger entries stored in the caf file
+      mutable std::shared_ptr<const TriggerIndex> fTriggerIndex;   ///< selected triggers and their entries in the file (shared with any clones)
   };
 
 }
@@ -10,6 +10,7 @@
 #include "DLP_h5_classes.h"
 #include "Params.h"
 #include "truth/FillTruth.h"
+#include "util/SRPool.h"
 
 using namespace cafmaker::types::dlp;
 
@@ -120,7 +121,7 @@ namespace cafmaker
 
   // ------------------------------------------------------------------------------
   // todo: possibly build some mechanism for customizing the dataset names in the file here
-  MLNDLArRecoBranchFiller::MLNDLArRecoBranchFiller(const std::string &h5filename)
+  MLNDLArRecoBranchFiller::MLNDLArRecoBranchFiller(const std::string &h5filename, std::size_t readBlockSize, std::size_t readAhead)
     : IRecoBranchFiller("LArML"),
       fDSReader(h5filename,
                 {{std::type_index(typeid(Particle)),                      "reco_particles"},
@@ -130,14 +131,37 @@ namespace cafmaker
                  {std::type_index(typeid(Flash)),                         "flashes"},
                  {std::type_index(typeid(Event)),                         "events"},
                  {std::type_index(typeid(RunInfo)),                       "run_info"},
-                 {std::type_index(typeid(cafmaker::types::dlp::Trigger)), "trigger"}}),  // needs to be disambiguated from CAFMaker's internal Trigger
-      fTriggers(),
-      fLastTriggerReqd(fTriggers.end())
+                 {std::type_index(typeid(cafmaker::types::dlp::Trigger)), "trigger"}})  // needs to be disambiguated from CAFMaker's internal Trigger
   {
+    fDSReader.SetReadBlockSize(readBlockSize);
+    fDSReader.SetReadAheadDepth(readAhead);
+
     // if we got this far, nothing bad happened trying to open the file or dataset
     SetConfigured(true);
   }
 
+  // ------------------------------------------------------------------------------
+  std::unique_ptr<IRecoBranchFiller> MLNDLArRecoBranchFiller::Clone() const
+  {
+    auto clone = std::make_unique<MLNDLArRecoBranchFiller>(fDSReader.InputFileName(), fDSReader.ReadBlockSize());
+    clone->SetLogThrehsold(LOG.GetThreshold());
+    clone->fTriggerIndex = fTriggerIndex;
+    clone->fDSReader.ShareRegionIndex(fDSReader);
+    return clone;
+  }
+
+  // ------------------------------------------------------------------------------
+  double MLNDLArRecoBranchFiller::EstimateCost(const Trigger &trigger) const
+  {
+    long int idx = fTriggerIndex->Entry(trigger);
+    if (idx < 0)
+      return 1.;
+
+    // only the sizes of the reference regions are needed, not the products themselves
+    return static_cast<double>(1 + fDSReader.NProducts<cafmaker::types::dlp::Interaction>(idx)
+                                 + fDSReader.NProducts<cafmaker::types::dlp::Particle>(idx));
+  }
+
   // ------------------------------------------------------------------------------
   void
   MLNDLArRecoBranchFiller::_FillRecoBranches(const Trigger &trigger,
@@ -146,21 +170,30 @@ namespace cafmaker
                                              const TruthMatcher *truthMatcher) const
 
   {
-    // figure out where in our list of triggers this event index is.
-    // we should always be looking forwards, since we expect to be traversing in that direction
-    auto it_start = (fLastTriggerReqd == fTriggers.end()) ? fTriggers.cbegin() : fLastTriggerReqd;
-    auto itTrig = std::find(it_start, fTriggers.cend(), trigger);
-    if (itTrig == fTriggers.end())
+    // figure out where in the file this trigger is
+    long int idx = fTriggerIndex->Entry(trigger);
+    if (idx < 0)
     {
       LOG.FATAL() << "Reco branch filler '" << GetName() << "' could not find trigger with evtID == " << trigger.evtID << "!  Abort.\n";
       abort();
     }
-    std::size_t idx = std::distance(fTriggers.cbegin(), itTrig);
 
     LOG.VERBOSE() << "    Reco branch filler '" << GetName() << "', trigger.evtID == " << trigger.evtID << ", internal evt idx = " << idx << ".\n";
-    idx = fEntryMap[idx];
     //Fill ND-LAr specific info in the meta branch
     H5DataView<cafmaker::types::dlp::RunInfo> run_info = fDSReader.GetProducts<cafmaker::types::dlp::RunInfo>(idx);
+
+    // the triggers after this one in the file are the likeliest to be asked for next.
+    // they can be read while this one is being filled
+    if (std::size_t depth = fDSReader.ReadAheadDepth())
+    {
+      std::vector<long int> upcoming;
+      const std::size_t nTriggers = fTriggerIndex->Triggers().size();
+      // (Position() isn't -1: Entry() found the trigger above)
+      for (std::size_t pos = static_cast<std::size_t>(fTriggerIndex->Position(trigger)) + 1; pos < nTriggers && upcoming.size() < depth; pos++)
+        upcoming.push_back(fTriggerIndex->EntryAt(pos));
+      fDSReader.ReadAhead(upcoming);
+    }
+
     sr.meta.lar2x2.enabled = true;
     for (const auto & runinf : run_info)
     {
@@ -389,7 +422,7 @@ namespace cafmaker
         {
           LOG.VERBOSE() << "  ** Match index " << idx << " --> truth ID " << ixn.match_ids[idx] << "\n";
           // here we need to search through the truth interactions and find the one with this ID (since it's no longer an index)
-          static DLPIxnComp ixnCmp;
+          DLPIxnComp ixnCmp{};
           ixnCmp.ixnID = ixn.match_ids[idx];
           auto itIxn = std::find_if(trueIxns.begin(), trueIxns.end(), ixnCmp);
           if (itIxn == trueIxns.end())
@@ -458,7 +491,7 @@ namespace cafmaker
     LOG.DEBUG() << "Filling reco particles...\n";
 
     // note: used in the hack further below
-    static SRPartCmp srPartCmp;
+    SRPartCmp srPartCmp{};
 
     //filling reco particles regardless of  type (track/shower)
     for (const auto & part : particles)
@@ -511,7 +544,7 @@ namespace cafmaker
 
           // first ask for the right truth match from the matcher.
           // if we have GENIE info it'll come pre-filled with all its info & sub-particles
-          static DLPIxnComp ixnCmp;
+          DLPIxnComp ixnCmp{};
           ixnCmp.ixnID = truePartPassThrough.interaction_id;
           auto it_ixn = std::find_if(trueInxns.begin(), trueInxns.end(), ixnCmp);
           if (it_ixn == trueInxns.end())
@@ -585,7 +618,7 @@ namespace cafmaker
                                            caf::StandardRecord &sr) const
   {
     // note: used in the hack further below
-    static SRPartCmp srPartCmp;
+    SRPartCmp srPartCmp{};
 
     for (const auto & part : particles)
     {
@@ -594,7 +627,7 @@ namespace cafmaker
         continue;
 
 
-      caf::SRTrack track;
+      caf::SRTrack track = SRPool<caf::SRTrack>::Acquire();
       // fill shower variables
       track.Evis = part.calo_ke/1000.;
       track.E = part.csda_ke/1000.; //range based energy
@@ -620,7 +653,7 @@ namespace cafmaker
 
           // first ask for the right truth match from the matcher.
           // if we have GENIE info it'll come pre-filled with all its info & sub-particles
-          static DLPIxnComp ixnCmp;
+          DLPIxnComp ixnCmp{};
           ixnCmp.ixnID = truePartPassThrough.interaction_id;
           auto it_ixn = std::find_if(trueInxns.begin(), trueInxns.end(), ixnCmp);
           if (it_ixn == trueInxns.end())
@@ -693,14 +726,14 @@ namespace cafmaker
                                             caf::StandardRecord &sr) const
   {
     // note: used in the hack further below
-    static SRPartCmp srPartCmp;
+    SRPartCmp srPartCmp{};
 
     for (const auto & part : particles)
     {
       if (part.shape != types::dlp::Shape::kShower)
         continue;
 
-      caf::SRShower shower;
+      caf::SRShower shower = SRPool<caf::SRShower>::Acquire();
       // fill shower variables
       shower.Evis = part.calo_ke/1000.;
       shower.start = caf::SRVector3D(part.start_point[0], part.start_point[1], part.start_point[2]);
@@ -722,7 +755,7 @@ namespace cafmaker
 
           // first ask for the right truth match from the matcher.
           // if we have GENIE info it'll come pre-filled with all its info & sub-particles
-          static DLPIxnComp ixnCmp;
+          DLPIxnComp ixnCmp{};
           ixnCmp.ixnID = truePartPassThrough.interaction_id;
           auto it_ixn = std::find_if(trueInxns.begin(), trueInxns.end(), ixnCmp);
           if (it_ixn == trueInxns.end())
@@ -822,13 +855,13 @@ namespace cafmaker
   // ------------------------------------------------------------------------------
   std::deque<Trigger> MLNDLArRecoBranchFiller::GetTriggers(int triggerType, bool beamOnly) const
   {
-    int iTrigger = 0;
     int entry = -1;
-    if (fTriggers.empty())
+    if (!fTriggerIndex)
     {
       auto triggersIn = fDSReader.GetProducts<cafmaker::types::dlp::Trigger>(-1); // get ALL the Trigger products
       LOG.DEBUG() << "Loading triggers with type " << triggerType << " within branch filler '" << GetName() << "' from " << triggersIn.size() << " ND-LAr RunInfo products:\n";
-      fTriggers.reserve(triggersIn.size());
+      auto index = std::make_shared<TriggerIndex>();
+      index->reserve(triggersIn.size());
       for (const cafmaker::types::dlp::Trigger &trigger: triggersIn)
       {
         entry +=1;
@@ -838,11 +871,7 @@ namespace cafmaker
           continue;
         }
 
-        fEntryMap[iTrigger] = entry;
-        iTrigger+=1;
-
-        fTriggers.emplace_back();
-        Trigger & trig = fTriggers.back();
+        Trigger trig;
         trig.evtID = trigger.id;
         trig.triggerType = trigger.type;
         trig.triggerTime_s = trigger.time_s;
@@ -853,14 +882,16 @@ namespace cafmaker
                       << ", triggerTime_s=" << trig.triggerTime_s
                       << ", triggerTime_ns=" << trig.triggerTime_ns
                       << "\n";
+        index->Add(trig, entry);
       }
-      fLastTriggerReqd = fTriggers.end();  // since we just modified the list, any iterators have been invalidated
+      fTriggerIndex = std::move(index);
     }
 
     std::deque<Trigger> triggers;
-    for (const Trigger & trigger : fTriggers)
+    const std::vector<Trigger> & trigList = fTriggerIndex->Triggers();
+    for (const Trigger & trigger : trigList)
     {
-      if (triggerType < 0 || triggerType == fTriggers.back().triggerType)
+      if (triggerType < 0 || triggerType == trigList.back().triggerType)
         triggers.push_back(trigger);
     }
 
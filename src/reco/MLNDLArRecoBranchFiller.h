@@ -15,6 +15,7 @@
 
 #include "reco/IRecoBranchFiller.h"
 #include "reco/NDLArDLPH5DatasetReader.h"
+#include "reco/TriggerIndex.h"
 
 namespace caf
 {
@@ -29,7 +30,9 @@ namespace cafmaker
   class MLNDLArRecoBranchFiller : public IRecoBranchFiller
   {
     public:
-      MLNDLArRecoBranchFiller(const std::string &h5filename);
+      /// \param readBlockSize  Number of consecutive events whose products are read at once (see NDLArDLPH5DatasetReader::SetReadBlockSize())
+      /// \param readAhead      Number of upcoming triggers whose products are read on a background thread (see NDLArDLPH5DatasetReader::SetReadAheadDepth())
+      MLNDLArRecoBranchFiller(const std::string &h5filename, std::size_t readBlockSize = 1, std::size_t readAhead = 0);
 
       std::deque<Trigger> GetTriggers(int triggerType, bool beamOnly) const override;
 
@@ -37,7 +40,12 @@ namespace cafmaker
 
       RecoFillerType FillerType() const override { return RecoFillerType::BaseReco; }
 
-      
+      /// Clones don't read ahead: each one only fills some of the triggers, so it can't tell which are coming next
+      std::unique_ptr<IRecoBranchFiller> Clone() const override;
+
+      /// Number of reconstructed interactions and particles in the trigger (plus one, for the trigger itself)
+      double EstimateCost(const Trigger &trigger) const override;
+
 
     protected:
       void _FillRecoBranches(const Trigger &trigger,
@@ -81,9 +89,7 @@ namespace cafmaker
                                const cafmaker::types::dlp::TrueInteraction & trueIntPassthrough) const;
 
       NDLArDLPH5DatasetReader fDSReader;
-      mutable std::vector<cafmaker::Trigger> fTriggers;
-      mutable decltype(fTriggers)::const_iterator  fLastTriggerReqd;    ///< the last trigger requested using _FillRecoBranches()
-      mutable std::map<int, int> fEntryMap; //Map of the filtered trigger entries stored in the caf file
+      mutable std::shared_ptr<const TriggerIndex> fTriggerIndex;   ///< selected triggers and their entries in the file (shared with any clones)
       
 
       
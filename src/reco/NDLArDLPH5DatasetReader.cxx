@@ -1,26 +1,366 @@
 #include "NDLArDLPH5DatasetReader.h"
 
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+namespace
+{
+  using cafmaker::types::dlp::Event;
+
+  // -----------------------------------------------------------
+  // resolve every event's region reference for product type T into a (start, count) extent, and add them to `index`.
+  // T is left out of the index if any of its regions isn't a single contiguous block
+  template <typename T, typename ExtentMap>
+  void IndexRegions(const H5::H5File & file,
+                    const std::unordered_map<std::type_index, std::string> & datasetNames,
+                    const std::vector<Event> & events,
+                    ExtentMap & index)
+  {
+    if (datasetNames.find(std::type_index(typeid(T))) == datasetNames.end())
+      return;
+
+    typename ExtentMap::mapped_type extents;
+    extents.reserve(events.size());
+    for (const Event & evt : events)
+    {
+      // const_cast is necessary because the argument is passed to a void* (that should really be a const void*)...
+      H5::DataSpace region = file.getRegion(&const_cast<hdset_reg_ref_t&>(evt.GetRef<T>()));
+      const hssize_t nPoints = region.getSelectNpoints();
+      if (nPoints <= 0)
+      {
+        extents.push_back({0, 0});
+        continue;
+      }
+
+      if (region.getSimpleExtentNdims() != 1)
+        return;
+      hsize_t start = 0;
+      hsize_t end = 0;
+      region.getSelectBounds(&start, &end);
+      if (end - start + 1 != static_cast<hsize_t>(nPoints))
+        return;
+
+      extents.push_back({start, static_cast<hsize_t>(nPoints)});
+    }
+
+    index[std::type_index(typeid(T))] = std::move(extents);
+  }
+}
+
 namespace cafmaker
 {
+  // -----------------------------------------------------------
+
+  struct NDLArDLPH5DatasetReader::ReadAheadState
+  {
+    /// One event's worth of products
+    struct Slot
+    {
+      long int evtIdx = -1;
+      std::unordered_map<std::type_index, std::unique_ptr<DatasetBufferBase>> buffers;
+    };
+
+    std::size_t depth = 0;
+
+    // everything below is guarded by `mutex`.
+    // lock order: never take the HDF5 lock while holding `mutex`
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<long int> pending;   ///< events still to be read, soonest first
+    long int inFlight = -2;         ///< event being read right now (-2 if none)
+    std::deque<Slot> ready;         ///< events that have been read
+    std::vector<Slot> spare;        ///< slots to read into, with their buffers for reuse
+    bool stop = false;
+
+    std::thread thread;
+  };
+
   // -----------------------------------------------------------
   // -----------------------------------------------------------
 
   NDLArDLPH5DatasetReader::NDLArDLPH5DatasetReader(const std::string &h5filename,
                                                    const std::unordered_map<std::type_index, std::string> &datasetNames)
-    : fInputFile(h5filename, H5F_ACC_RDONLY), fDatasetNames(datasetNames)
-  {}
+    : fDatasetNames(datasetNames), fRegionIndex(std::make_shared<RegionIndex>())
+  {
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+    fInputFile.openFile(h5filename, H5F_ACC_RDONLY);
+  }
 
   // -----------------------------------------------------------
 
+  NDLArDLPH5DatasetReader::~NDLArDLPH5DatasetReader()
+  {
+    StopReadAhead();
+
+    // release our HDF5 handles while holding the lock,
+    // rather than leaving it to the member destructors
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+    fDatasetBuffers.clear();
+    fInputFile.close();
+  }
+
+  // -----------------------------------------------------------
+
+
   std::string NDLArDLPH5DatasetReader::InputFileName() const
   {
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
     return fInputFile.getFileName();
   }
 
   // -----------------------------------------------------------
 
+  void NDLArDLPH5DatasetReader::BuildRegionIndex() const
+  {
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+    if (fRegionIndex->built)
+      return;
+
+    // HDF5 can't be called from more than one thread at a time anyway,
+    // so this is one pass over the events, with the whole 'events' table read in one go
+    H5::DataSet evtDS = fInputFile.openDataSet(GetDatasetName<Event>());
+    H5::DataSpace evtDSP = evtDS.getSpace();
+    std::vector<Event> events(static_cast<std::size_t>(evtDSP.getSimpleExtentNpoints()));
+    if (!events.empty())
+      evtDS.read(events.data(), cafmaker::types::dlp::BuildCompType<Event>());
+
+    using namespace cafmaker::types::dlp;
+    IndexRegions<Interaction>(fInputFile, fDatasetNames, events, fRegionIndex->extents);
+    IndexRegions<Particle>(fInputFile, fDatasetNames, events, fRegionIndex->extents);
+    IndexRegions<TrueInteraction>(fInputFile, fDatasetNames, events, fRegionIndex->extents);
+    IndexRegions<TrueParticle>(fInputFile, fDatasetNames, events, fRegionIndex->extents);
+    IndexRegions<Flash>(fInputFile, fDatasetNames, events, fRegionIndex->extents);
+    IndexRegions<RunInfo>(fInputFile, fDatasetNames, events, fRegionIndex->extents);
+    IndexRegions<cafmaker::types::dlp::Trigger>(fInputFile, fDatasetNames, events, fRegionIndex->extents);
 
+    fRegionIndex->built = true;
+  }
+
+  // -----------------------------------------------------------
 
+  void NDLArDLPH5DatasetReader::ShareRegionIndex(const NDLArDLPH5DatasetReader & other)
+  {
+    fRegionIndex = other.fRegionIndex;
+  }
 
+  // -----------------------------------------------------------
+
+  void NDLArDLPH5DatasetReader::InvalidateCache() const
+  {
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+    for (auto & typeBuffer : fDatasetBuffers)
+      typeBuffer.second->cached = false;
+    fCachedEvtIdx = -2;
+  }
+
+  // -----------------------------------------------------------
+
+  void NDLArDLPH5DatasetReader::SetReadAheadDepth(std::size_t depth)
+  {
+    StopReadAhead();
+    if (depth == 0)
+      return;
+
+    fReadAhead = std::make_unique<ReadAheadState>();
+    fReadAhead->depth = depth;
+    fReadAhead->thread = std::thread(&NDLArDLPH5DatasetReader::ReadAheadLoop, this);
+  }
+
+  // -----------------------------------------------------------
+
+  std::size_t NDLArDLPH5DatasetReader::ReadAheadDepth() const
+  {
+    return fReadAhead ? fReadAhead->depth : 0;
+  }
+
+  // -----------------------------------------------------------
+
+  void NDLArDLPH5DatasetReader::ReadAhead(const std::vector<long int> & evtIdxs) const
+  {
+    if (!fReadAhead)
+      return;
+
+    std::lock_guard<std::mutex> lock(fReadAhead->mutex);
+    const std::size_t nWanted = std::min(evtIdxs.size(), fReadAhead->depth);
+    const auto wantedEnd = evtIdxs.begin() + static_cast<std::ptrdiff_t>(nWanted);
+    auto wanted = [&evtIdxs, wantedEnd](long int evtIdx)
+    {
+      return std::find(evtIdxs.begin(), wantedEnd, evtIdx) != wantedEnd;
+    };
+
+    // guesses that didn't pan out
+    for (auto it = fReadAhead->ready.begin(); it != fReadAhead->ready.end(); )
+    {
+      if (wanted(it->evtIdx))
+      {
+        it++;
+        continue;
+      }
+      fReadAhead->spare.push_back(std::move(*it));
+      it = fReadAhead->ready.erase(it);
+    }
+
+    fReadAhead->pending.clear();
+    for (std::size_t i = 0; i < nWanted; i++)
+    {
+      const long int evtIdx = evtIdxs[i];
+      if (evtIdx == fReadAhead->inFlight
+          || std::any_of(fReadAhead->ready.begin(), fReadAhead->ready.end(),
+                         [evtIdx](const ReadAheadState::Slot & slot) { return slot.evtIdx == evtIdx; }))
+        continue;
+      fReadAhead->pending.push_back(evtIdx);
+    }
+    fReadAhead->cv.notify_all();
+  }
+
+  // -----------------------------------------------------------
+
+  void NDLArDLPH5DatasetReader::AdoptReadAhead(long int evtIdx) const
+  {
+    ReadAheadState::Slot slot;
+    {
+      std::unique_lock<std::mutex> lock(fReadAhead->mutex);
+
+      // if it's being read right now, waiting for it is quicker than starting over
+      fReadAhead->cv.wait(lock, [this, evtIdx] { return fReadAhead->inFlight != evtIdx; });
+
+      auto it = std::find_if(fReadAhead->ready.begin(), fReadAhead->ready.end(),
+                             [evtIdx](const ReadAheadState::Slot & s) { return s.evtIdx == evtIdx; });
+      if (it == fReadAhead->ready.end())
+        return;
+      slot = std::move(*it);
+      fReadAhead->ready.erase(it);
+    }
+
+    {
+      std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+      InvalidateCache();
+      fCachedEvtIdx = evtIdx;
+
+      // trade our buffers for the read-ahead ones.
+      // ours go back to the read-ahead thread, so the views into them are done with
+      for (auto & typeBuffer : slot.buffers)
+      {
+        if (!typeBuffer.second || !typeBuffer.second->cached)
+          continue;
+        std::swap(fDatasetBuffers[typeBuffer.first], typeBuffer.second);
+        if (typeBuffer.second)
+          typeBuffer.second->recycle();
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(fReadAhead->mutex);
+    fReadAhead->spare.push_back(std::move(slot));
+    fReadAhead->cv.notify_all();
+  }
+
+  // -----------------------------------------------------------
+
+  template <typename T>
+  void NDLArDLPH5DatasetReader::ReadAheadProducts(std::unique_ptr<DatasetBufferBase> & buffer, long int evtIdx) const
+  {
+    if (fDatasetNames.find(std::type_index(typeid(T))) == fDatasetNames.end())
+      return;
+
+    // without the index, the 'events' row would be needed, and that belongs to the thread calling GetProducts()
+    const RegionIndex::Extent * extent = FindExtent<T>(evtIdx);
+    if (!extent)
+      return;
+
+    if (!buffer)
+      buffer = std::make_unique<DatasetBuffer<T>>(fInputFile, GetDatasetName<T>(), cafmaker::types::dlp::BuildCompType<T>);
+    auto dsBuffer = static_cast<DatasetBuffer<T>*>(buffer.get());
+
+    // no recycle(): the generation is only ever changed by the thread that makes views into the buffer,
+    // and it already did so when it handed the buffer over
+    dsBuffer->vlArena.Reset();
+    ReadExtent(*dsBuffer, *extent);
+    dsBuffer->viewBegin = 0;
+    dsBuffer->viewSize = dsBuffer->size();
+    dsBuffer->blockFirstEvt = dsBuffer->blockEndEvt = 0;
+    dsBuffer->cached = true;
+  }
+
+  // -----------------------------------------------------------
+
+  void NDLArDLPH5DatasetReader::ReadAheadLoop()
+  {
+    using namespace cafmaker::types::dlp;
+
+    std::unique_lock<std::mutex> lock(fReadAhead->mutex);
+    while (true)
+    {
+      fReadAhead->cv.wait(lock, [this]
+      {
+        return fReadAhead->stop || (!fReadAhead->pending.empty() && fReadAhead->ready.size() < fReadAhead->depth);
+      });
+      if (fReadAhead->stop)
+        return;
+
+      ReadAheadState::Slot slot;
+      if (!fReadAhead->spare.empty())
+      {
+        slot = std::move(fReadAhead->spare.back());
+        fReadAhead->spare.pop_back();
+      }
+      slot.evtIdx = fReadAhead->pending.front();
+      fReadAhead->pending.pop_front();
+      fReadAhead->inFlight = slot.evtIdx;
+      lock.unlock();
+
+      // only what's read for this event gets taken over
+      for (auto & typeBuffer : slot.buffers)
+      {
+        if (typeBuffer.second)
+          typeBuffer.second->cached = false;
+      }
+
+      bool ok = true;
+      try
+      {
+        std::lock_guard<std::recursive_mutex> h5lock(util::HDF5Mutex());
+        ReadAheadProducts<RunInfo>(slot.buffers[typeid(RunInfo)], slot.evtIdx);
+        ReadAheadProducts<Interaction>(slot.buffers[typeid(Interaction)], slot.evtIdx);
+        ReadAheadProducts<TrueInteraction>(slot.buffers[typeid(TrueInteraction)], slot.evtIdx);
+        ReadAheadProducts<TrueParticle>(slot.buffers[typeid(TrueParticle)], slot.evtIdx);
+        ReadAheadProducts<Particle>(slot.buffers[typeid(Particle)], slot.evtIdx);
+        ReadAheadProducts<Flash>(slot.buffers[typeid(Flash)], slot.evtIdx);
+      }
+      catch (...)
+      {
+        // whatever went wrong will go wrong again when GetProducts() reads the event itself,
+        // where it can be reported properly
+        ok = false;
+      }
+
+      lock.lock();
+      fReadAhead->inFlight = -2;
+      if (ok)
+        fReadAhead->ready.push_back(std::move(slot));
+      else
+        fReadAhead->spare.push_back(std::move(slot));
+      fReadAhead->cv.notify_all();
+    }
+  }
+
+  // -----------------------------------------------------------
+
+  void NDLArDLPH5DatasetReader::StopReadAhead()
+  {
+    if (!fReadAhead)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock(fReadAhead->mutex);
+      fReadAhead->stop = true;
+    }
+    fReadAhead->cv.notify_all();
+    fReadAhead->thread.join();
+
+    // its buffers hold HDF5 handles
+    std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+    fReadAhead.reset();
+  }
 
 } // namespace cafmaker
@@ -9,8 +9,11 @@
 #ifndef ND_CAFMAKER_NDLARDLPH5DATASETREADER_H
 #define ND_CAFMAKER_NDLARDLPH5DATASETREADER_H
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <typeinfo>
 #include <typeindex>
 #include <unordered_map>
@@ -21,6 +24,7 @@
 #include "readH5/DatasetBuffer.h"
 #include "readH5/H5DataView.h"
 #include "readH5/IH5Viewer.h"
+#include "util/HDF5Mutex.h"
 
 namespace cafmaker
 {
@@ -41,6 +45,8 @@ namespace cafmaker
       NDLArDLPH5DatasetReader(const std::string & h5filename,
                               const std::unordered_map<std::type_index, std::string> & datasetNames);
 
+      ~NDLArDLPH5DatasetReader() override;
+
       template <typename T>
       const std::string & GetDatasetName() const
       {
@@ -51,11 +57,37 @@ namespace cafmaker
         return it->second;
       }
 
-      /// Retrieve all of the products for a given event index (or all events if given -1)
+      /// Retrieve all of the products for a given event index (or all events if given -1).
+      ///
+      /// Products already read for the same index are returned again without going back to the file.
+      /// Asking for a different index forgets all of them.
+      /// The rows for an event's products are found from the region index (see RegionIndex) rather than the 'events' dataset.
+      /// With SetReadBlockSize(), they're read along with the next few events' (and views of those are then just sub-spans).
+      ///
+      /// With SetReadAheadDepth(), products the read-ahead thread has already read for the event are taken over from it instead.
+      ///
+      /// A view stays valid until a request for the same product type has to read from the file again
+      /// (or takes over a read-ahead buffer).
+      /// So do the BufferViews of its variable-length fields: their memory comes from the buffer's VLArena,
+      /// which is released in one go at that point.
       template <typename T>
       H5DataView<T> GetProducts(long int evtIdx=-1) const
       {
-        // todo: implement a caching mechanism so repeated requests for the same evtIdx don't cause re-reads from the file
+        // the 'events' rows aren't read ahead (and NProducts() asks for them while holding the HDF5 lock,
+        // which the read-ahead thread might be waiting for)
+        if constexpr (!std::is_same_v<T, cafmaker::types::dlp::Event>)
+        {
+          if (fReadAhead && evtIdx >= 0 && evtIdx != fCachedEvtIdx)
+            AdoptReadAhead(evtIdx);
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+
+        if (evtIdx != fCachedEvtIdx)
+        {
+          InvalidateCache();
+          fCachedEvtIdx = evtIdx;
+        }
 
         if (fDatasetBuffers.find(typeid(T)) == fDatasetBuffers.end())
           fDatasetBuffers.emplace(typeid(T), std::make_unique<DatasetBuffer<T>>(fInputFile,
@@ -63,12 +95,30 @@ namespace cafmaker
                                                                                 cafmaker::types::dlp::BuildCompType<T>));
 
         auto dsBuffer = dynamic_cast<DatasetBuffer<T>*>(fDatasetBuffers.at(typeid(T)).get());
+        if (dsBuffer->cached)
+          return NewView<T>(dsBuffer->viewData(), dsBuffer->viewSize, &dsBuffer->generation);
+
+        // these products might already be in the block that's been read
+        if constexpr (!std::is_same_v<T, cafmaker::types::dlp::Event>)
+        {
+          if (evtIdx >= dsBuffer->blockFirstEvt && evtIdx < dsBuffer->blockEndEvt)
+          {
+            const RegionIndex::Extent * extent = FindExtent<T>(evtIdx);
+            dsBuffer->viewBegin = extent->count > 0 ? extent->start - dsBuffer->blockFirstRow : 0;
+            dsBuffer->viewSize = extent->count;
+            dsBuffer->cached = true;
+            return NewView<T>(dsBuffer->viewData(), dsBuffer->viewSize, &dsBuffer->generation);
+          }
+        }
+
+        // anything below overwrites the buffer (and the variable-length data its rows point to)
+        dsBuffer->recycle();
 
         // the easy case is if the user wants all entries.  no filtering then...
         if (evtIdx < 0)
         {
           dsBuffer->resize(dsBuffer->nEntries);
-          dsBuffer->ds.read(dsBuffer->data(), dsBuffer->compType(), H5::DataSpace::ALL, H5::DataSpace::ALL);
+          dsBuffer->ds.read(dsBuffer->data(), dsBuffer->compType(), H5::DataSpace::ALL, H5::DataSpace::ALL, dsBuffer->xfer);
           dsBuffer->syncVectors();
         }
         else
@@ -93,9 +143,20 @@ namespace cafmaker
             count[0] = 1;
             memspace.selectHyperslab(H5S_SELECT_SET, count.data(), start.data());
 
-            dsBuffer->ds.read(dsBuffer->data(), dsBuffer->compType(), memspace, dsp);
+            dsBuffer->ds.read(dsBuffer->data(), dsBuffer->compType(), memspace, dsp, dsBuffer->xfer);
             dsBuffer->syncVectors();
           } // if (T == Event)
+          else if (fReadBlockSize > 1 && FindExtent<T>(evtIdx) && ReadBlock(*dsBuffer, evtIdx))
+          {
+            // the block starts with this event
+            const RegionIndex::Extent * extent = FindExtent<T>(evtIdx);
+            dsBuffer->viewBegin = extent->count > 0 ? extent->start - dsBuffer->blockFirstRow : 0;
+            dsBuffer->viewSize = extent->count;
+            dsBuffer->cached = true;
+            return NewView<T>(dsBuffer->viewData(), dsBuffer->viewSize, &dsBuffer->generation);
+          } // else if (reading blocks)
+          else if (const RegionIndex::Extent * extent = FindExtent<T>(evtIdx))
+            ReadExtent(*dsBuffer, *extent);
           else
           {
             H5DataView<cafmaker::types::dlp::Event> evts = GetProducts<cafmaker::types::dlp::Event>(evtIdx);
@@ -122,25 +183,188 @@ namespace cafmaker
             std::vector<hsize_t> count(1, static_cast<hsize_t>(ref_region.getSelectNpoints()));
             memspace.selectHyperslab(H5S_SELECT_SET, count.data(), start.data());
 
-            ds_ref.read(dsBuffer->data(), dsBuffer->compType(), memspace, ref_region);
+            ds_ref.read(dsBuffer->data(), dsBuffer->compType(), memspace, ref_region, dsBuffer->xfer);
             dsBuffer->syncVectors();
           } // else if (T != Event)
         } // else if (evtIdx >= 0)
+        dsBuffer->cached = true;
+        dsBuffer->viewBegin = 0;
+        dsBuffer->viewSize = dsBuffer->size();
 
-        H5DataView<T> view = NewView<T>(dsBuffer->bufferaddr());
+        H5DataView<T> view = NewView<T>(dsBuffer->viewData(), dsBuffer->viewSize, &dsBuffer->generation);
 
         return view;
       } // H5DataView<T> NDLArDLPH5DatasetReader::GetProducts()
 
+      /// How many products of type T an event has, without reading them in
+      template <typename T>
+      std::size_t NProducts(long int evtIdx) const
+      {
+        std::lock_guard<std::recursive_mutex> lock(util::HDF5Mutex());
+
+        if (const RegionIndex::Extent * extent = FindExtent<T>(evtIdx))
+          return static_cast<std::size_t>(extent->count);
+
+        H5DataView<cafmaker::types::dlp::Event> evts = GetProducts<cafmaker::types::dlp::Event>(evtIdx);
+        // const_cast is necessary because the argument is passed to a void* (that should really be a const void*)...
+        H5::DataSpace ref_region = fInputFile.getRegion(&const_cast<hdset_reg_ref_t&>(evts[0].GetRef<T>()));
+        return static_cast<std::size_t>(ref_region.getSelectNpoints());
+      }
+
 
       std::string InputFileName() const;
 
+      /// Forget the products read so far, so that the next request for them goes back to the file
+      void InvalidateCache() const;
+
+      /// \brief Read the products for this many consecutive events at a time (1, the default, reads one event at a time).
+      ///
+      /// SPINE files store events in order, so when triggers are processed in order,
+      /// the products for the next few are read in one large, sequential read per dataset
+      /// instead of many small ones.  This pays off most for files streamed over the network (dCache, xrootd).
+      /// Blocks are read ahead of the requested event, so it's wasted effort if events are asked for out of order.
+      void SetReadBlockSize(std::size_t nEvents)  { fReadBlockSize = std::max<std::size_t>(nEvents, 1); }
+      std::size_t ReadBlockSize() const  { return fReadBlockSize; }
+
+      /// \brief Read the products of upcoming events on a background thread, up to `depth` events ahead (0, the default, doesn't).
+      ///
+      /// Which events are coming up is told to the thread with ReadAhead().
+      /// While the caller is busy with the current event's products, the thread reads the next events' into buffers of its own,
+      /// which GetProducts() then takes over instead of reading.
+      /// Only products found through the region index are read ahead; blocks (SetReadBlockSize()) aren't used for them.
+      /// HDF5 calls are still one at a time (see util::HDF5Mutex()), so what's gained is the overlap with whatever the caller does in between.
+      void SetReadAheadDepth(std::size_t depth);
+      std::size_t ReadAheadDepth() const;
+
+      /// Tell the read-ahead thread which events will be asked for next, soonest first.
+      /// Events it has already read that aren't in the list are dropped.  Does nothing if read-ahead is off
+      void ReadAhead(const std::vector<long int> & evtIdxs) const;
+
+      /// Use the region index of another reader of the same file (e.g., the one this reader's filler was cloned from)
+      /// instead of building one of its own
+      void ShareRegionIndex(const NDLArDLPH5DatasetReader & other);
+
     private:
+      /// Where each event's products are in each dataset, resolved once from the region references in 'events'.
+      /// Dereferencing a region reference is one of the slowest things HDF5 does, so it's done for every event up front,
+      /// the first time any event's products are asked for.  After that, reading them is a plain hyperslab read
+      struct RegionIndex
+      {
+        struct Extent
+        {
+          hsize_t start = 0;   ///< first row
+          hsize_t count = 0;   ///< number of rows
+        };
+
+        bool built = false;
+
+        /// Extent of each event's products, by product type.
+        /// A type whose regions aren't all single contiguous blocks isn't here, and still goes through the references
+        std::unordered_map<std::type_index, std::vector<Extent>> extents;
+      };
+
+      /// Build the region index, if nobody has yet
+      void BuildRegionIndex() const;
+
+      /// The read-ahead thread and the buffers it has filled (see SetReadAheadDepth())
+      struct ReadAheadState;
+
+      /// If the read-ahead thread has read (or is reading) event `evtIdx`, make its buffers the current ones
+      void AdoptReadAhead(long int evtIdx) const;
+
+      /// What the read-ahead thread runs
+      void ReadAheadLoop();
+
+      /// Stop the read-ahead thread (if there is one) and discard what it's read
+      void StopReadAhead();
+
+      /// Read type T's products for an event into a read-ahead buffer (which is made if it's null).
+      /// Nothing is read if T's regions aren't indexed
+      template <typename T>
+      void ReadAheadProducts(std::unique_ptr<DatasetBufferBase> & buffer, long int evtIdx) const;
+
+      /// Read one contiguous block of rows into the buffer, straight out of the already-open dataset
+      template <typename T>
+      void ReadExtent(DatasetBuffer<T> & dsBuffer, const RegionIndex::Extent & extent) const
+      {
+        dsBuffer.resize(extent.count);
+        if (extent.count > 0)
+        {
+          dsBuffer.dsp.selectHyperslab(H5S_SELECT_SET, &extent.count, &extent.start);
+          dsBuffer.memsp.setExtentSimple(1, &extent.count);
+          dsBuffer.ds.read(dsBuffer.data(), dsBuffer.compType(), dsBuffer.memsp, dsBuffer.dsp, dsBuffer.xfer);
+        }
+        dsBuffer.syncVectors();
+      }
+
+      /// Read the rows of events `evtIdx` to `evtIdx + fReadBlockSize - 1` into the buffer in one go.
+      /// Only done if T's rows for those events are back-to-back in the dataset
+      /// \return  Whether the block was read
+      template <typename T>
+      bool ReadBlock(DatasetBuffer<T> & dsBuffer, long int evtIdx) const
+      {
+        const std::vector<RegionIndex::Extent> & extents = fRegionIndex->extents.at(std::type_index(typeid(T)));
+        const long int endEvt = std::min(evtIdx + static_cast<long int>(fReadBlockSize), static_cast<long int>(extents.size()));
+
+        bool anyRows = false;
+        hsize_t firstRow = 0;
+        hsize_t endRow = 0;
+        for (long int evt = evtIdx; evt < endEvt; evt++)
+        {
+          const RegionIndex::Extent & extent = extents[static_cast<std::size_t>(evt)];
+          if (extent.count == 0)
+            continue;
+          if (!anyRows)
+          {
+            firstRow = endRow = extent.start;
+            anyRows = true;
+          }
+          if (extent.start != endRow)
+            return false;
+          endRow += extent.count;
+        }
+
+        const hsize_t nRows = endRow - firstRow;
+        dsBuffer.resize(nRows);
+        if (nRows > 0)
+        {
+          dsBuffer.dsp.selectHyperslab(H5S_SELECT_SET, &nRows, &firstRow);
+          dsBuffer.memsp.setExtentSimple(1, &nRows);
+          dsBuffer.ds.read(dsBuffer.data(), dsBuffer.compType(), dsBuffer.memsp, dsBuffer.dsp, dsBuffer.xfer);
+        }
+        dsBuffer.syncVectors();
+
+        dsBuffer.blockFirstEvt = evtIdx;
+        dsBuffer.blockEndEvt = endEvt;
+        dsBuffer.blockFirstRow = firstRow;
+        return true;
+      }
+
+      /// Where type T's products for event `evtIdx` are, or null if they have to be found from the region reference
+      template <typename T>
+      const RegionIndex::Extent * FindExtent(long int evtIdx) const
+      {
+        BuildRegionIndex();
+
+        auto it = fRegionIndex->extents.find(std::type_index(typeid(T)));
+        if (it == fRegionIndex->extents.end())
+          return nullptr;
+        if (static_cast<std::size_t>(evtIdx) >= it->second.size())
+          throw std::out_of_range("Event index " + std::to_string(evtIdx) + " is beyond the end of dataset '" + GetDatasetName<T>() + "'");
+        return &it->second[static_cast<std::size_t>(evtIdx)];
+      }
+
+
       H5::H5File  fInputFile;
 
       std::unordered_map<std::type_index, std::string> fDatasetNames;
 
       mutable std::unordered_map<std::type_index, std::unique_ptr<DatasetBufferBase>> fDatasetBuffers;
+      mutable long int fCachedEvtIdx = -2;   ///< the event index the cached products are for (-1 is 'all events', so -2 is 'none')
+
+      std::shared_ptr<RegionIndex> fRegionIndex;   ///< shared with the readers of any clones of our filler
+      std::size_t fReadBlockSize = 1;
+      std::unique_ptr<ReadAheadState> fReadAhead;   ///< null unless read-ahead is on
   };
 }
 
@@ -199,6 +199,12 @@ namespace cafmaker
     }
   }
 
+  // matchers hold nothing but their configuration, so a copy is already independent
+  std::unique_ptr<IRecoBranchFiller> NDLArMINERvAMatchRecoFiller::Clone() const
+  {
+    return std::make_unique<NDLArMINERvAMatchRecoFiller>(*this);
+  }
+
   std::deque<Trigger> NDLArMINERvAMatchRecoFiller::GetTriggers(int triggerType, bool beamOnly) const
   {
     return std::deque<Trigger>();
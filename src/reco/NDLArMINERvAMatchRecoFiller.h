@@ -23,6 +23,8 @@ namespace cafmaker
       
       RecoFillerType FillerType() const override { return RecoFillerType::Matcher; }
 
+      std::unique_ptr<IRecoBranchFiller> Clone() const override;
+
       std::deque<Trigger> GetTriggers(int triggerType, bool beamOnly) const override;
 
 
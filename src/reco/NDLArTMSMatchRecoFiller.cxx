@@ -79,6 +79,12 @@ namespace cafmaker
 //    }
   }
 
+  // matchers hold nothing but their configuration, so a copy is already independent
+  std::unique_ptr<IRecoBranchFiller> NDLArTMSMatchRecoFiller::Clone() const
+  {
+    return std::make_unique<NDLArTMSMatchRecoFiller>(*this);
+  }
+
   // todo: this is a placeholder
   std::deque<Trigger> NDLArTMSMatchRecoFiller::GetTriggers(int triggerType, bool beamOnly) const
   {
@@ -340,6 +340,12 @@ namespace cafmaker
       Create_matches(possibleSPINEMatches,sr);
       }
   }
+  // matchers hold nothing but their configuration, so a copy is already independent
+  std::unique_ptr<IRecoBranchFiller> NDLArTMSUniqueMatchRecoFiller::Clone() const
+  {
+    return std::make_unique<NDLArTMSUniqueMatchRecoFiller>(*this);
+  }
+
   // todo: this is a placeholder
   std::deque<Trigger> NDLArTMSUniqueMatchRecoFiller::GetTriggers(int triggerType, bool beamOnly) const
   {
@@ -40,6 +40,8 @@ namespace cafmaker
 
       RecoFillerType FillerType() const override { return RecoFillerType::Matcher; }
 
+      std::unique_ptr<IRecoBranchFiller> Clone() const override;
+
     private:
       void MatchTracks(caf::StandardRecord &sr) const;
 
@@ -1,6 +1,7 @@
 #include "PandoraLArRecoNDBranchFiller.h"
 
 #include "Params.h"
+#include "util/SRPool.h"
 
 namespace cafmaker
 {
@@ -8,8 +9,6 @@ namespace cafmaker
   PandoraLArRecoNDBranchFiller::PandoraLArRecoNDBranchFiller(const std::string &pandoraLArRecoNDFilename,
                                                              const float LArDensity)
       : IRecoBranchFiller("PandoraLArRecoND"),
-        m_Triggers(),
-        m_LastTriggerReqd(m_Triggers.end()),
         m_LArDensity(LArDensity)
   {
     // Open Pandora LArRecoND hierarchy analysis ROOT file
@@ -64,29 +63,34 @@ namespace cafmaker
     }
   }
 
+  std::unique_ptr<IRecoBranchFiller> PandoraLArRecoNDBranchFiller::Clone() const
+  {
+    auto clone = std::make_unique<PandoraLArRecoNDBranchFiller>(m_LArRecoNDFile->GetName(), m_LArDensity);
+    clone->SetLogThrehsold(LOG.GetThreshold());
+    clone->m_TriggerIndex = m_TriggerIndex;
+    return clone;
+  }
+
   // Copy all of the Pandora LArRecoND info to the PandoraLArRecoND branch of the StandardRecord object
   void PandoraLArRecoNDBranchFiller::_FillRecoBranches(const Trigger &trigger,
                                                        caf::StandardRecord &sr,
                                                        const cafmaker::Params &par,
                                                        const TruthMatcher *truthMatch) const
   {
-    // Figure out where in our list of triggers this event index is.
-    // We should always be looking forwards, since we expect to be traversing in that direction
-    auto it_start = (m_LastTriggerReqd == m_Triggers.end()) ? m_Triggers.cbegin() : m_LastTriggerReqd;
-    auto itTrig = std::find(it_start, m_Triggers.cend(), trigger);
-    if (itTrig == m_Triggers.end())
+    // Figure out where in the file this trigger is
+    long int idx = m_TriggerIndex->Entry(trigger);
+    if (idx < 0)
     {
       LOG.FATAL() << " Reco branch filler '" << GetName() << "' could not find trigger with evtID == "
                   << trigger.evtID << "!  Abort.\n";
       abort();
     }
-    std::size_t idx = std::distance(m_Triggers.cbegin(), itTrig);
 
     LOG.VERBOSE() << " Reco branch filler '" << GetName() << "', trigger.evtID == " << trigger.evtID
                   << ", internal evt idx = " << idx << ".\n";
 
     // Get the event entry
-    m_LArRecoNDTree->GetEntry(fEntryMap[idx]);
+    m_LArRecoNDTree->GetEntry(idx);
 
     // Set the event and run numbers
     sr.meta.nd_lar.enabled = true;
@@ -173,7 +177,7 @@ namespace cafmaker
         continue;
 
       // Create standard record track
-      caf::SRTrack track;
+      caf::SRTrack track = SRPool<caf::SRTrack>::Acquire();
       // Starting position (vertex or first hit location)
       const float startX = (m_startXVect != nullptr) ? (*m_startXVect)[i] : 0.0;
       const float startY = (m_startYVect != nullptr) ? (*m_startYVect)[i] : 0.0;
@@ -352,7 +356,7 @@ namespace cafmaker
         continue;
 
       // Create standard record shower
-      caf::SRShower shower;
+      caf::SRShower shower = SRPool<caf::SRShower>::Acquire();
       // Starting position
       const float startX = (m_startXVect != nullptr) ? (*m_startXVect)[i] : 0.0;
       const float startY = (m_startYVect != nullptr) ? (*m_startYVect)[i] : 0.0;
@@ -502,15 +506,14 @@ namespace cafmaker
   // ------------------------------------------------------------------------------
   std::deque<Trigger> PandoraLArRecoNDBranchFiller::GetTriggers(int triggerType, bool beamOnly) const
   {
-    int iTrigger = 0;
-
-    if (m_Triggers.empty())
+    if (!m_TriggerIndex)
     {
       const int nEvents = m_LArRecoNDTree->GetEntries();
       LOG.DEBUG() << "Loading triggers with type " << triggerType << " within branch filler '" << GetName()
                   << "' from " << nEvents << " Pandora LArRecoND tree entries:\n";
 
-      m_Triggers.reserve(nEvents);
+      auto index = std::make_shared<TriggerIndex>();
+      index->reserve(static_cast<std::size_t>(nEvents));
       for (int entry = 0; entry < nEvents; entry++)
       {
         m_LArRecoNDTree->GetEntry(entry);
@@ -521,11 +524,7 @@ namespace cafmaker
           continue;
         }
 
-        fEntryMap[iTrigger] = entry;
-        iTrigger += 1;
-
-        m_Triggers.emplace_back();
-        Trigger &trig = m_Triggers.back();
+        Trigger trig;
         // Event number
         trig.evtID = m_eventId;
 
@@ -540,15 +539,16 @@ namespace cafmaker
                       << ", triggerTime_s = " << trig.triggerTime_s
                       << ", triggerTime_ns = " << trig.triggerTime_ns
                       << "\n";
+        index->Add(trig, entry);
       }
-      // Since we just modified the list, any iterators have been invalidated
-      m_LastTriggerReqd = m_Triggers.end();
+      m_TriggerIndex = std::move(index);
     }
 
     std::deque<Trigger> triggers;
-    for (const Trigger &trigger : m_Triggers)
+    const std::vector<Trigger> &trigList = m_TriggerIndex->Triggers();
+    for (const Trigger &trigger : trigList)
     {
-      if (triggerType < 0 || triggerType == m_Triggers.back().triggerType)
+      if (triggerType < 0 || triggerType == trigList.back().triggerType)
         triggers.push_back(trigger);
     }
 
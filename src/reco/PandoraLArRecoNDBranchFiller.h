@@ -10,6 +10,7 @@
 
 // The virtual base class
 #include "reco/IRecoBranchFiller.h"
+#include "reco/TriggerIndex.h"
 #include "truth/FillTruth.h"
 
 // ROOT headers
@@ -34,6 +35,8 @@ namespace cafmaker
 
       RecoFillerType FillerType() const override { return RecoFillerType::BaseReco; }
 
+      std::unique_ptr<IRecoBranchFiller> Clone() const override;
+
     private:
       void _FillRecoBranches(const Trigger &trigger,
            caf::StandardRecord &sr,
@@ -78,9 +81,7 @@ namespace cafmaker
       std::vector<int> *m_isRecoPrimaryVect = nullptr;
       std::vector<int> *m_recoPDGVect = nullptr;
 
-      mutable std::vector<cafmaker::Trigger> m_Triggers;
-      mutable decltype(m_Triggers)::const_iterator  m_LastTriggerReqd; ///< the last trigger requested using _FillRecoBranches
-      mutable std::map<int, int> fEntryMap; //Map of the filtered trigger entries stored in the caf file
+      mutable std::shared_ptr<const TriggerIndex> m_TriggerIndex; ///< selected triggers and their entries in the file (shared with any clones)
       const float m_LArDensity;
   };
 
@@ -36,6 +36,13 @@ namespace cafmaker
       SetConfigured(true);
   }
 
+  std::unique_ptr<IRecoBranchFiller> SANDRecoBranchFiller::Clone() const
+  {
+    auto clone = std::make_unique<SANDRecoBranchFiller>(fSANDRecoFile->GetName());
+    clone->SetLogThrehsold(LOG.GetThreshold());
+    return clone;
+  }
+
   void SANDRecoBranchFiller::_FillRecoBranches(std::size_t N, std::size_t ii, 
 					       caf::StandardRecord &sr,
 					       const cafmaker::Params &par) const
@@ -103,6 +110,12 @@ namespace cafmaker
     abort();
   }
 
+  std::unique_ptr<IRecoBranchFiller> SANDRecoBranchFiller::Clone() const
+  {
+    error_msg();
+    abort();
+  }
+
   void SANDRecoBranchFiller::
   _FillRecoBranches(const Trigger &, caf::StandardRecord &, const cafmaker::Params &,
                     const TruthMatcher *truthMatcher) const
@@ -25,6 +25,8 @@ namespace cafmaker
 
       RecoFillerType FillerType() const override { return RecoFillerType::BaseReco; }
 
+      std::unique_ptr<IRecoBranchFiller> Clone() const override;
+
 
     private:
       void _FillRecoBranches(const Trigger &trigger,
@@ -1,4 +1,7 @@
 #include "TMSRecoBranchFiller.h"
+
+#include <algorithm>
+
 #include "truth/FillTruth.h"
 
 /*
@@ -10,9 +13,7 @@ namespace cafmaker
 {
 
   TMSRecoBranchFiller::TMSRecoBranchFiller(const std::string &tmsRecoFilename)
-    : IRecoBranchFiller("TMS"),
-    fTriggers(),
-    fLastTriggerReqd(fTriggers.end())
+    : IRecoBranchFiller("TMS")
   {
     fTMSRecoFile = new TFile(tmsRecoFilename.c_str(), "READ");
     name = std::string("TMS");
@@ -88,6 +89,31 @@ namespace cafmaker
     fTMSRecoFile = NULL;
   }
 
+  // ---------------------------------------------------------------------------
+  std::unique_ptr<IRecoBranchFiller> TMSRecoBranchFiller::Clone() const
+  {
+    auto clone = std::make_unique<TMSRecoBranchFiller>(fTMSRecoFile->GetName());
+    clone->SetLogThrehsold(LOG.GetThreshold());
+    clone->fTriggerIndex = fTriggerIndex;
+    return clone;
+  }
+
+  // ---------------------------------------------------------------------------
+  double TMSRecoBranchFiller::EstimateCost(const Trigger &trigger) const
+  {
+    long int idx = fTriggerIndex->Position(trigger);
+    if (idx < 0)
+      return 1.;
+
+    // each spill's entries are contiguous, and each trigger points to the first of them
+    const std::vector<Trigger> & triggers = fTriggerIndex->Triggers();
+    long int firstEntry = fTriggerIndex->EntryAt(static_cast<std::size_t>(idx));
+    long int endEntry = static_cast<std::size_t>(idx) + 1 < triggers.size()
+                        ? fTriggerIndex->EntryAt(static_cast<std::size_t>(idx) + 1)
+                        : static_cast<long int>(TMSRecoTree->GetEntries());
+    return static_cast<double>(std::max(endEntry - firstEntry, 1L));
+  }
+
   // ---------------------------------------------------------------------------
 
   // here we copy all the TMS reco into the SRTMS branch of the StandardRecord object.
@@ -101,18 +127,15 @@ namespace cafmaker
 
     // Nicked from the MINVERvA example:
     // figure out where in our list of triggers this event index is.
-    // we should always be looking forwards, since we expect to be traversing in that direction
-    auto it_start = (fLastTriggerReqd == fTriggers.end()) ? fTriggers.cbegin() : fLastTriggerReqd;
-    auto itTrig = std::find(it_start, fTriggers.cend(), trigger);
-    if (itTrig == fTriggers.end())
+    long int idx = fTriggerIndex->Position(trigger);
+    if (idx < 0)
     {
       LOG.FATAL() << "Reco branch filler '" << GetName() << "' could not find trigger with evtID == " << trigger.evtID << "!  Abort.\n";
       abort();
     }
-    std::size_t idx = std::distance(fTriggers.cbegin(), itTrig);
     LOG.VERBOSE() << "    Reco branch filler '" << GetName() << "', trigger.evtID == " << trigger.evtID << ", internal evt idx = " << idx << ".\n";
 
-    int i = trigger.evtID; // pseudo-itterator for ixn
+    long int i = fTriggerIndex->EntryAt(static_cast<std::size_t>(idx)); // pseudo-itterator for ixn
     // Get nth entry from tree
 
     int LastSpillNo = -999999; //_SpillNo;
@@ -181,10 +204,11 @@ namespace cafmaker
     std::deque<Trigger> triggers;
     int lastSpillNo = -99999999;
 
-    if (fTriggers.empty())
+    if (!fTriggerIndex)
     {
       LOG.DEBUG() << "Loading triggers with type " << triggerType << " within branch filler '" << GetName() << "' from " << TMSRecoTree->GetEntries() << " TMS Reco_Tree:\n";
-      fTriggers.reserve(TMSRecoTree->GetEntries());
+      auto index = std::make_shared<TriggerIndex>();
+      index->reserve(static_cast<std::size_t>(TMSRecoTree->GetEntries()));
 
       for (int entry = 0; entry < TMSRecoTree->GetEntries(); entry++)
       {
@@ -195,23 +219,22 @@ namespace cafmaker
 
         lastSpillNo = _SpillNo;
 
-        Trigger & prev_trig = fTriggers.back(); // trigger before 'trig'
-        fTriggers.emplace_back();               // add new trigger entry (unfilled)
-        Trigger & trig      = fTriggers.back(); // trigger we're working on
+        Trigger trig;  // trigger we're working on
 
         trig.evtID = entry;
         trig.triggerType = 1; // TODO real number?
 
+        const Trigger * prev_trig = index->Triggers().empty() ? nullptr : &index->Triggers().back(); // trigger before 'trig'
         if (entry == 0) // TODO do this less bad
           trig.triggerTime_ns = 0;
         else
-          trig.triggerTime_ns = prev_trig.triggerTime_ns + 2E8 ;
+          trig.triggerTime_ns = prev_trig->triggerTime_ns + 2E8 ;
 
         if (entry == 0) // TODO do this less bad
           trig.triggerTime_s = 0;
         else
         {
-          trig.triggerTime_s = prev_trig.triggerTime_s + 1; // TODO: Pull the 1.2 from correct place in file
+          trig.triggerTime_s = prev_trig->triggerTime_s + 1; // TODO: Pull the 1.2 from correct place in file
           if (trig.triggerTime_ns >= 1E9)
           {
             trig.triggerTime_s += 1;
@@ -224,13 +247,15 @@ namespace cafmaker
                       << ", triggerTime_s=" << trig.triggerTime_s
                       << ", triggerTime_ns=" << trig.triggerTime_ns
                       << "\n";
+        index->Add(trig, entry);
       }
-      fLastTriggerReqd = fTriggers.end();  // since we just modified the list, any iterators have been invalidated
+      fTriggerIndex = std::move(index);
     }
 
-    for (const Trigger & trigger : fTriggers)
+    const std::vector<Trigger> & trigList = fTriggerIndex->Triggers();
+    for (const Trigger & trigger : trigList)
     {
-      if (triggerType < 0 || triggerType == fTriggers.back().triggerType)
+      if (triggerType < 0 || triggerType == trigList.back().triggerType)
       {
         triggers.push_back(trigger);
       }
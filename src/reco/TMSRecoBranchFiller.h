@@ -13,6 +13,7 @@
 
 // The virtual base class
 #include "IRecoBranchFiller.h"
+#include "TriggerIndex.h"
 
 // File handlers from ROOT
 #include "TFile.h"
@@ -32,6 +33,11 @@ namespace cafmaker
 
       RecoFillerType FillerType() const override { return RecoFillerType::BaseReco; }
 
+      std::unique_ptr<IRecoBranchFiller> Clone() const override;
+
+      /// Number of Reco_Tree entries (reconstructed events) in the trigger's spill
+      double EstimateCost(const Trigger &trigger) const override;
+
       ~TMSRecoBranchFiller();
 
     private:
@@ -81,8 +87,7 @@ namespace cafmaker
       int _RecoTruePartIdSec[10]; //Secondary 
 
       bool is_data;
-      mutable std::vector<cafmaker::Trigger> fTriggers;
-      mutable decltype(fTriggers)::const_iterator  fLastTriggerReqd;    ///< the last trigger requested using _FillRecoBranches()
+      mutable std::shared_ptr<const TriggerIndex> fTriggerIndex;   ///< triggers and their entries in the file (shared with any clones)
 
   };
 
@@ -0,0 +1,267 @@
+#include "TriggerGrouping.h"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <sstream>
+#include <tuple>
+
+#include "util/Logger.h"
+
+namespace cafmaker
+{
+  // -----------------------------------------------------------
+  bool doTriggersMatch(const Trigger& t1, const Trigger& t2, unsigned int dT)
+  {
+    const unsigned long int s_to_ns = 1e9;
+    return ( (std::max(t1.triggerTime_s, t2.triggerTime_s) - std::min(t1.triggerTime_s, t2.triggerTime_s)) * s_to_ns + std::max(t1.triggerTime_ns, t2.triggerTime_ns) - std::min(t1.triggerTime_ns, t2.triggerTime_ns) ) < dT;
+  }
+
+  // -----------------------------------------------------------
+  namespace
+  {
+    // I don't want to keep typing `cafmaker::LOG_S("TriggerGrouper")` every time,
+    // and the preamble to the logger resets after the first use
+    const cafmaker::Logger & LOG()
+    {
+      return cafmaker::LOG_S("TriggerGrouper");
+    }
+  }
+
+  // -----------------------------------------------------------
+  TriggerGrouper::TriggerGrouper(std::map<const IRecoBranchFiller*, std::deque<Trigger>> triggersByFiller,
+                                 unsigned int trigMatchMaxDT)
+    : fTrigMatchMaxDT(trigMatchMaxDT),
+      fTimingStage(Timing::Get().Enabled() ? &Timing::Get().Stage("TriggerGrouping") : nullptr)
+  {
+    ScopedTimer timer(fTimingStage);
+
+    fStreams.reserve(triggersByFiller.size());
+
+    // don't assume input comes in sorted
+    LOG().INFO() << "Incoming counts of triggers from upstream:\n";
+    for (auto & fillerTrigPair : triggersByFiller)
+    {
+      std::sort(fillerTrigPair.second.begin(), fillerTrigPair.second.end(), triggerTimeCmp());
+      LOG().INFO() << "   " << fillerTrigPair.first->GetName() << " --> " << fillerTrigPair.second.size() << "\n";
+      fNTriggersByFiller.push_back(fillerTrigPair.second.size());
+      fNTriggers += fillerTrigPair.second.size();
+      fStreams.push_back({fillerTrigPair.first, std::move(fillerTrigPair.second), 0});
+    }
+    fNTriggersLeft = fNTriggers;
+
+    for (std::size_t streamIdx = 0; streamIdx < fStreams.size(); streamIdx++)
+      PushFront(streamIdx);
+  }
+
+  // -----------------------------------------------------------
+  bool TriggerGrouper::Next(TriggerGroup & trigGroup)
+  {
+    ScopedTimer timer(fTimingStage);
+    const bool verbose = LOG().GetThreshold() <= Logger::THRESHOLD::VERBOSE;
+
+    trigGroup.clear();
+    while (!fHeap.empty())
+    {
+      std::pop_heap(fHeap.begin(), fHeap.end(), HeapEntry::Later);
+      const HeapEntry seed = fHeap.back();
+      fHeap.pop_back();
+      if (seed.version != fStreams[seed.stream].version)
+        continue;
+
+      if (verbose)
+      {
+        LOG().VERBOSE() << "   Considering the earliest triggers in each stream:\n";
+        for (const TriggerStream & stream : fStreams)
+        {
+          if (stream.triggers.empty())
+            continue;
+          LOG().VERBOSE() << "       " << stream.filler->GetName() << " --> (id = " << stream.triggers.front().evtID
+                          << ", time = " << (stream.triggers.front().triggerTime_s + stream.triggers.front().triggerTime_ns/1e9) << " s)\n";
+        }
+      }
+
+      // the earliest one is our next group seed.
+      // pull it out of its stream so we don't reconsider it for the next group
+      TriggerStream & seedStream = fStreams[seed.stream];
+      trigGroup.push_back({seedStream.filler, std::move(seedStream.triggers.front())});  // note that we're stealing the contents of the element from its deque since we're about to pop it anyway
+      seedStream.triggers.pop_front();
+      PushFront(seed.stream);
+
+      const Trigger refTrigger = trigGroup.front().second;  // a copy, since trigGroup grows below
+      const bool refIsBeam = trigGroup.front().first->IsBeamTrigger(refTrigger.triggerType);
+      LOG().VERBOSE() << "    --> Building trigger group with seed: (" << refTrigger.evtID << ", "
+                      << refTrigger.triggerTime_s + refTrigger.triggerTime_ns/1e9
+                      << ")\n";
+
+      // now consider the other reco filler streams.
+      // do they have any events in them that should go in this group?
+      LOG().VERBOSE() << "    Considering other triggers:\n";
+      for (std::size_t streamIdx = 0; streamIdx < fStreams.size(); streamIdx++)
+      {
+        TriggerStream & stream = fStreams[streamIdx];
+        if (streamIdx == seed.stream || stream.triggers.empty())
+          continue;
+
+        // we only want to match together triggers of the same type, or beam triggers.
+        // the first trigger in the stream almost always qualifies, so check it before searching
+        auto typeMatches = [&](const Trigger & t)
+        {
+          return t.triggerType == refTrigger.triggerType || (refIsBeam && stream.filler->IsBeamTrigger(t.triggerType));
+        };
+        bool frontChanged = false;
+        if (!typeMatches(stream.triggers.front()))
+        {
+          auto itTrig = std::find_if(std::next(stream.triggers.begin()), stream.triggers.end(), typeMatches);
+          if (itTrig == stream.triggers.end())
+            continue;  // no trigger that matches the reference trigger's type
+
+          // move the trigger to the front
+          std::rotate(stream.triggers.begin(), itTrig, std::next(itTrig));
+          frontChanged = true;
+        }
+
+        // we will only take at most one trigger from each of the other streams.
+        // since the seed was the earliest one out of all the triggers,
+        // we only need to check the first one in each other stream
+        const Trigger & trig = stream.triggers.front();
+        if (doTriggersMatch(refTrigger, trig, fTrigMatchMaxDT))
+        {
+          LOG().VERBOSE() << "       " << stream.filler->GetName() << ", " << trig.evtID << " -->  MATCHES\n";
+          trigGroup.push_back({stream.filler, std::move(stream.triggers.front())});
+          stream.triggers.pop_front();
+          frontChanged = true;
+        }
+        else
+          LOG().VERBOSE() << "       " << stream.filler->GetName() << ", " << trig.evtID << " --> does NOT MATCH\n";
+
+        if (frontChanged)
+          PushFront(streamIdx);
+      } // for (streamIdx)
+
+      // stale entries only pile up when the type matching shuffles a stream.
+      // don't let them accumulate
+      if (fHeap.size() > 4 * fStreams.size())
+      {
+        fHeap.clear();
+        for (std::size_t streamIdx = 0; streamIdx < fStreams.size(); streamIdx++)
+          PushFront(streamIdx);
+      }
+
+      fNTriggersLeft -= trigGroup.size();
+      if (trigGroup.size() == 1)
+        fNUnmatched++;
+
+      if (LOG().GetThreshold() <= cafmaker::Logger::THRESHOLD::DEBUG)
+      {
+        LOG().DEBUG() << "Trigger group #" << fNGroups << ":\n";
+        for (const auto & groupTrig : trigGroup)
+        {
+          LOG().DEBUG() << "   " << groupTrig.first->GetName() << " trigger " << groupTrig.second.evtID
+                        << " at time " << groupTrig.second.triggerTime_s + 1e-9*groupTrig.second.triggerTime_ns << "\n";
+        }
+      }
+      fNGroups++;
+
+      return true;
+    } // while (!fHeap.empty())
+
+    return false;
+  }
+
+  // -----------------------------------------------------------
+  std::size_t TriggerGrouper::Skip(std::size_t n)
+  {
+    TriggerGroup trigGroup;
+    std::size_t nSkipped = 0;
+    while (nSkipped < n && Next(trigGroup))
+      nSkipped++;
+    return nSkipped;
+  }
+
+  // -----------------------------------------------------------
+  void TriggerGrouper::ReportUnmatched() const
+  {
+    if (fStreams.size() < 2 || fNUnmatched == 0)
+      return;
+
+    std::stringstream ss;
+    for (std::size_t trigByFillerIdx = 0; trigByFillerIdx < fNTriggersByFiller.size(); trigByFillerIdx++)
+    {
+      ss << fNTriggersByFiller[trigByFillerIdx];
+      if (trigByFillerIdx < fNTriggersByFiller.size() - 1)
+        ss << " + ";
+    }
+    // if the event loop stopped early, only the groups built so far have been checked
+    if (!Done())
+      ss << " I was given, in the " << fNGroups << " groups built";
+    else
+      ss << " I was given";
+    LOG().WARNING() << "There were " << fNUnmatched << " triggers (of the " << ss.str()
+                    << ") that did not match across fillers.  Is that consistent with your expectations?\n";
+  }
+
+  // -----------------------------------------------------------
+  void TriggerGrouper::PushFront(std::size_t streamIdx)
+  {
+    TriggerStream & stream = fStreams[streamIdx];
+    stream.version++;
+    if (stream.triggers.empty())
+      return;
+
+    const Trigger & front = stream.triggers.front();
+    fHeap.push_back({front.triggerTime_s, front.triggerTime_ns, streamIdx, stream.version});
+    std::push_heap(fHeap.begin(), fHeap.end(), HeapEntry::Later);
+  }
+
+  // -----------------------------------------------------------
+  std::vector<TriggerGroup> buildTriggerList(std::map<const IRecoBranchFiller*, std::deque<Trigger>> triggersByFiller,
+                                             unsigned int trigMatchMaxDT)
+  {
+    TriggerGrouper grouper(std::move(triggersByFiller), trigMatchMaxDT);
+
+    std::vector<TriggerGroup> ret;
+    TriggerGroup trigGroup;
+    while (grouper.Next(trigGroup))
+      ret.push_back(std::move(trigGroup));
+
+    grouper.ReportUnmatched();
+    return ret;
+  }
+
+  // -----------------------------------------------------------
+  std::pair<std::size_t, std::size_t> FindShardRange(const std::vector<double> & groupCosts,
+                                                     unsigned int shard,
+                                                     unsigned int nShards)
+  {
+    if (nShards == 0 || shard >= nShards)
+      throw std::invalid_argument("Invalid shard " + std::to_string(shard) + " of " + std::to_string(nShards));
+
+    const double totalCost = std::accumulate(groupCosts.begin(), groupCosts.end(), 0.);
+    if (!(totalCost > 0))
+    {
+      // nothing to weight by.  fall back to splitting by count
+      return { groupCosts.size() * shard / nShards, groupCosts.size() * (shard + 1) / nShards };
+    }
+
+    // the shard assignment never decreases along the groups, so this shard is a contiguous range
+    std::size_t first = groupCosts.size();
+    std::size_t last = groupCosts.size();
+    double costBefore = 0;
+    for (std::size_t groupIdx = 0; groupIdx < groupCosts.size(); groupIdx++)
+    {
+      const double midpoint = costBefore + groupCosts[groupIdx] / 2;
+      const auto groupShard = std::min(static_cast<unsigned int>(midpoint / totalCost * nShards), nShards - 1);
+      if (groupShard >= shard && first == groupCosts.size())
+        first = groupIdx;
+      if (groupShard > shard)
+      {
+        last = groupIdx;
+        break;
+      }
+      costBefore += groupCosts[groupIdx];
+    }
+    return { first, std::max(first, last) };
+  }
+}
@@ -0,0 +1,141 @@
+/// \file TriggerGrouping.h
+///
+/// Matching up the triggers from the various reco branch fillers
+/// into groups that will each become one StandardRecord
+///
+
+#ifndef ND_CAFMAKER_TRIGGERGROUPING_H
+#define ND_CAFMAKER_TRIGGERGROUPING_H
+
+#include <deque>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "reco/IRecoBranchFiller.h"
+#include "util/Timing.h"
+
+namespace cafmaker
+{
+  /// One group of matched triggers, and the reco filler each came from
+  using TriggerGroup = std::vector<std::pair<const IRecoBranchFiller*, Trigger>>;
+
+  /// Are two triggers within dT (in ns) of each other?
+  bool doTriggersMatch(const Trigger& t1, const Trigger& t2, unsigned int dT);
+
+  /// Orders triggers by time
+  struct triggerTimeCmp
+  {
+    bool operator()(const Trigger &t1, const Trigger &t2) const
+    {
+      return t1.triggerTime_s < t2.triggerTime_s ||
+             (t1.triggerTime_s == t2.triggerTime_s && t1.triggerTime_ns < t2.triggerTime_ns);
+    }
+  };
+
+  /// \brief Merges the trigger streams from the reco fillers into groups of matching triggers, one group at a time
+  ///
+  /// Each group is seeded by the earliest remaining trigger of all the streams
+  /// (ties go to the stream that comes first in the map).
+  /// Each of the other streams contributes at most one trigger to the group:
+  /// its first trigger of a compatible type (the same type, or both beam triggers),
+  /// if that's within trigMatchMaxDT ns of the seed.
+  ///
+  /// Groups are only built as they are asked for, so nothing beyond the input streams
+  /// themselves needs to be held in memory while the event loop runs.
+  class TriggerGrouper
+  {
+    public:
+      /// \param triggersByFiller  Triggers from each filler (need not be sorted).  Pass with std::move() to avoid a copy.
+      /// \param trigMatchMaxDT    Maximum time difference (in ns) for triggers to be grouped together
+      TriggerGrouper(std::map<const IRecoBranchFiller*, std::deque<Trigger>> triggersByFiller,
+                     unsigned int trigMatchMaxDT);
+
+      /// Build the next group (the groups come out in order of their seed times).
+      /// \return false, leaving `group` empty, once every trigger has been grouped
+      bool Next(TriggerGroup & group);
+
+      /// Build the next `n` groups and throw them away
+      /// \return  The number of groups actually skipped (fewer than `n` if the triggers ran out)
+      std::size_t Skip(std::size_t n);
+
+      /// Have all the triggers been grouped?
+      bool Done() const  { return fNTriggersLeft == 0; }
+
+      /// Number of groups built so far (including skipped ones)
+      std::size_t NGroups() const  { return fNGroups; }
+
+      /// Number of triggers given to the constructor
+      std::size_t NTriggers() const  { return fNTriggers; }
+
+      /// Number of triggers not yet placed in a group
+      std::size_t NTriggersLeft() const  { return fNTriggersLeft; }
+
+      /// Warn about any groups so far that consist of a single trigger
+      /// (when there is more than one stream to match across)
+      void ReportUnmatched() const;
+
+    private:
+      struct TriggerStream
+      {
+        const IRecoBranchFiller * filler;
+        std::deque<Trigger> triggers;
+        unsigned int version;   ///< bumped every time the front trigger changes
+      };
+
+      // min-heap entry for the earliest trigger in a stream.
+      // rather than fixing up the heap when the front of a stream changes,
+      // a new entry is pushed, and the old one is recognized as stale (by its version) when it surfaces
+      struct HeapEntry
+      {
+        unsigned long int triggerTime_s;
+        unsigned int      triggerTime_ns;
+        std::size_t       stream;
+        unsigned int      version;
+
+        /// Heap ordering: later triggers sink, and simultaneous ones go to the earlier stream
+        static bool Later(const HeapEntry & a, const HeapEntry & b)
+        {
+          return std::tie(a.triggerTime_s, a.triggerTime_ns, a.stream) > std::tie(b.triggerTime_s, b.triggerTime_ns, b.stream);
+        }
+      };
+
+      void PushFront(std::size_t streamIdx);
+
+      unsigned int fTrigMatchMaxDT;
+      TimingStage * fTimingStage = nullptr;   ///< looked up once, since Next() is called a lot
+      std::vector<TriggerStream> fStreams;    ///< in map order (which is what breaks ties between simultaneous triggers)
+      std::vector<HeapEntry> fHeap;
+
+      std::vector<std::size_t> fNTriggersByFiller;
+      std::size_t fNTriggers = 0;
+      std::size_t fNTriggersLeft = 0;
+      std::size_t fNGroups = 0;
+      std::size_t fNUnmatched = 0;
+  };
+
+  /// \brief Group all the triggers at once.  See TriggerGrouper for how the groups are made.
+  ///
+  /// \param triggersByFiller  Triggers from each filler (need not be sorted).  Pass with std::move() to avoid a copy.
+  /// \param trigMatchMaxDT    Maximum time difference (in ns) for triggers to be grouped together
+  /// \return  The trigger groups, in order of their seed times
+  std::vector<TriggerGroup> buildTriggerList(std::map<const IRecoBranchFiller*, std::deque<Trigger>> triggersByFiller,
+                                             unsigned int trigMatchMaxDT);
+
+  /// \brief Split the trigger groups into contiguous shards of about equal total cost
+  ///
+  /// A group goes to the shard its cost midpoint falls into, when the groups' costs are laid end to end.
+  /// The result only depends on the costs, so every job computing it agrees on the split,
+  /// and the shards concatenated in order cover every group exactly once.
+  ///
+  /// \param groupCosts  Estimated cost of each trigger group, in order
+  /// \param shard       Which shard to return (0 to nShards-1)
+  /// \param nShards     How many shards to split into
+  /// \return  The range [first, last) of group indices in the shard.  (It may be empty if there are very few groups.)
+  std::pair<std::size_t, std::size_t> FindShardRange(const std::vector<double> & groupCosts,
+                                                     unsigned int shard,
+                                                     unsigned int nShards);
+}
+
+#endif //ND_CAFMAKER_TRIGGERGROUPING_H
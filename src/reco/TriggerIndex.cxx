@@ -0,0 +1,43 @@
+#include "TriggerIndex.h"
+
+#include <functional>
+
+namespace cafmaker
+{
+  // -----------------------------------------------------------
+  std::size_t TriggerIndex::KeyHash::operator()(const Key & key) const
+  {
+    std::size_t h = std::hash<long int>()(key.first);
+    return h ^ (std::hash<int>()(key.second) + 0x9e3779b9 + (h << 6) + (h >> 2));
+  }
+
+  // -----------------------------------------------------------
+  void TriggerIndex::Add(const Trigger & trigger, long int entry)
+  {
+    fPositions.emplace(Key{trigger.evtID, trigger.triggerType}, fTriggers.size());
+    fTriggers.push_back(trigger);
+    fEntries.push_back(entry);
+  }
+
+  // -----------------------------------------------------------
+  long int TriggerIndex::Position(const Trigger & trigger) const
+  {
+    auto it = fPositions.find(Key{trigger.evtID, trigger.triggerType});
+    return it == fPositions.end() ? -1 : static_cast<long int>(it->second);
+  }
+
+  // -----------------------------------------------------------
+  long int TriggerIndex::Entry(const Trigger & trigger) const
+  {
+    long int pos = Position(trigger);
+    return pos < 0 ? -1 : fEntries[static_cast<std::size_t>(pos)];
+  }
+
+  // -----------------------------------------------------------
+  void TriggerIndex::reserve(std::size_t n)
+  {
+    fTriggers.reserve(n);
+    fEntries.reserve(n);
+    fPositions.reserve(n);
+  }
+}
@@ -0,0 +1,58 @@
+/// \file TriggerIndex.h
+///
+/// Lookup table from the triggers a reco branch filler hands out
+/// back to where they live in its input file
+///
+
+#ifndef ND_CAFMAKER_TRIGGERINDEX_H
+#define ND_CAFMAKER_TRIGGERINDEX_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "reco/IRecoBranchFiller.h"
+
+namespace cafmaker
+{
+  /// The triggers found in one reco filler's input, in file order,
+  /// together with a constant-time map from each of them to its entry in the file.
+  ///
+  /// Built once in GetTriggers() and then only read,
+  /// so a filler's clones can all share the same instance.
+  class TriggerIndex
+  {
+    public:
+      /// Record that `trigger` is stored at `entry` in the input.
+      /// If a trigger with the same evtID and triggerType was already added, the first one wins.
+      void Add(const Trigger & trigger, long int entry);
+
+      /// Position of a trigger within Triggers(), or -1 if it was never added
+      long int Position(const Trigger & trigger) const;
+
+      /// Input entry for a trigger previously passed to Add(), or -1 if there wasn't one
+      long int Entry(const Trigger & trigger) const;
+
+      /// Input entry of the trigger at `position` within Triggers()
+      long int EntryAt(std::size_t position) const  { return fEntries[position]; }
+
+      /// All the triggers passed to Add(), in the order they were added
+      const std::vector<Trigger> & Triggers() const  { return fTriggers; }
+
+      void reserve(std::size_t n);
+
+    private:
+      // the same fields Trigger::operator==() compares
+      using Key = std::pair<long int, int>;
+      struct KeyHash
+      {
+        std::size_t operator()(const Key & key) const;
+      };
+
+      std::vector<Trigger> fTriggers;
+      std::vector<long int> fEntries;    ///< parallel to fTriggers
+      std::unordered_map<Key, std::size_t, KeyHash> fPositions;
+  };
+}
+
+#endif //ND_CAFMAKER_TRIGGERINDEX_H
@@ -11,6 +11,16 @@ namespace cafmaker
     dsp.getSimpleExtentDims(dims);
     nEntries = dims[dimsMax - 1];
     delete[] dims;
+
+    xfer.setVlenMemManager(VLArena::H5Allocate, &vlArena, VLArena::H5Free, &vlArena);
+  }
+
+  void DatasetBufferBase::recycle()
+  {
+    generation++;
+    blockFirstEvt = blockEndEvt = 0;
+    cached = false;
+    vlArena.Reset();
   }
 
 
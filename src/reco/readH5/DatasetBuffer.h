@@ -14,6 +14,8 @@
 
 #include "H5Cpp.h"
 
+#include "VLArena.h"
+
 namespace cafmaker
 {
   /// Base for the dataset buffer storage containing non-templated shared stuff
@@ -24,8 +26,33 @@ namespace cafmaker
 
     H5::DataSet ds;
     H5::DataSpace dsp;
+    H5::DataSpace memsp{H5S_SIMPLE};   //< reused for the memory side of each read
+
+    /// Where the variable-length fields of the rows in the buffer live.
+    /// Pass `xfer` to every read into the buffer so that HDF5 allocates them from here
+    VLArena vlArena;
+    H5::DSetMemXferPropList xfer;
 
     std::size_t nEntries;   //< loaded from dataset
+
+    bool cached = false;    //< does the buffer hold what was last asked for?  (the reader decides what that is)
+
+    /// Bumped every time the buffer is overwritten, which invalidates the H5DataViews into it
+    std::size_t generation = 0;
+
+    /// The rows of the buffer that the most recent request was for
+    std::size_t viewBegin = 0;
+    std::size_t viewSize = 0;
+
+    /// When the buffer holds a block of consecutive events (see NDLArDLPH5DatasetReader::SetReadBlockSize()):
+    /// the first and one-past-last event in it, and the dataset row its first element came from
+    long int blockFirstEvt = 0;
+    long int blockEndEvt = 0;
+    hsize_t blockFirstRow = 0;
+
+    /// Call before overwriting the buffer: invalidates the views into it,
+    /// forgets the block, and releases the variable-length data of the rows in it all at once
+    void recycle();
   };
 
   /// Storage class for the buffer used for an HDF structured datatype,
@@ -48,6 +75,9 @@ namespace cafmaker
       /// Get the address of the underlying std::vector buffer
       const std::vector <T> * bufferaddr() const { return &fBuffer; }
 
+      /// The rows the most recent request was for
+      const T * viewData() const { return fBuffer.data() + viewBegin; }
+
       /// ensure any vectors within type T are synchronized with the HDF5 'handles'
       /// call this after loading data into the buffer...
       void syncVectors()
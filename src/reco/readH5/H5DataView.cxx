@@ -21,7 +21,8 @@ namespace cafmaker
   // -----------------------------------------------------------
 
   H5DataViewBase::H5DataViewBase(const H5DataViewBase & other)
-    : fValid(other.fValid), fViewer(other.fViewer)
+    : fValid(other.fValid), fViewer(other.fViewer),
+      fGeneration(other.fGeneration), fCreatedGeneration(other.fCreatedGeneration)
   {}
 
 
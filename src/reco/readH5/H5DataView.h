@@ -8,8 +8,8 @@
 #ifndef ND_CAFMAKER_H5DATAVIEW_H
 #define ND_CAFMAKER_H5DATAVIEW_H
 
+#include <cstddef>
 #include <stdexcept>
-#include <vector>
 
 namespace cafmaker
 {
@@ -27,12 +27,23 @@ namespace cafmaker
 
       virtual ~H5DataViewBase();
 
-      bool valid() const  { return fValid; };    ///< Check if this view is valid.  If not, it should be discarded
+      /// Check if this view is valid.  If not, it should be discarded
+      bool valid() const  { return fValid && (!fGeneration || *fGeneration == fCreatedGeneration); }
       void invalidate()   { fValid = false; }    ///< Set this view status to invalid
 
+    protected:
+      /// Views into a buffer that gets overwritten (see DatasetBufferBase::generation) become invalid when it is
+      void WatchGeneration(const std::size_t * generation)
+      {
+        fGeneration = generation;
+        fCreatedGeneration = generation ? *generation : 0;
+      }
+
     private:
       bool fValid = true;
       const IH5Viewer * fViewer;
+      const std::size_t * fGeneration = nullptr;
+      std::size_t fCreatedGeneration = 0;
   };
 
   // -----------------------------------------------------------
@@ -40,6 +51,8 @@ namespace cafmaker
   /// Wrapper class for viewing the contents of an HDF5 dataset
   /// that consists of a sequence of a structured type,
   /// which is mapped to the C++ class passed as the template argument.
+  /// The view is a contiguous span of rows in a buffer owned by the reader
+  /// (which may hold more rows than the view covers).
   /// This viewer maintains an internal state corresponding to whether the view is valid.
   template <typename T>
   class H5DataView : public H5DataViewBase
@@ -48,33 +61,34 @@ namespace cafmaker
     friend class IH5Viewer;
 
     public:
-      const std::vector<T> & operator*() const
+      // enable use with range-based for
+      const T * begin() const
       {
         if(valid())
-          return *fBuffer;
+          return fData;
         throw std::runtime_error("H5DataView is invalid");
       }
-
-      // enable use with range-based for
-      const auto begin() const { return fBuffer->begin(); }
-      const auto end()   const { return fBuffer->end(); }
+      const T * end() const { return begin() + fSize; }
 
       // other vector-like operations
-      std::size_t size() const { return fBuffer->size(); }
+      std::size_t size() const { return fSize; }
 
       const T & operator[](std::size_t idx) const
       {
         if(valid())
-          return (*fBuffer)[idx];
+          return fData[idx];
         throw std::runtime_error("H5DataView is invalid");
       }
 
     private:
-      H5DataView(const IH5Viewer * reader, const std::vector<T> * vec)
-      : H5DataViewBase(reader), fBuffer(vec)
-      {}
+      H5DataView(const IH5Viewer * reader, const T * data, std::size_t size, const std::size_t * generation = nullptr)
+      : H5DataViewBase(reader), fData(data), fSize(size)
+      {
+        WatchGeneration(generation);
+      }
 
-      const std::vector<T> * fBuffer;
+      const T * fData;
+      std::size_t fSize;
   };
 
 }
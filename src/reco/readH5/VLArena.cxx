@@ -0,0 +1,60 @@
+#include "VLArena.h"
+
+#include <algorithm>
+
+namespace cafmaker
+{
+  // -----------------------------------------------------------
+
+  VLArena::VLArena(std::size_t chunkSize)
+    : fChunkSize(chunkSize)
+  {}
+
+  // -----------------------------------------------------------
+
+  void * VLArena::Allocate(std::size_t nBytes)
+  {
+    // keep everything aligned for any type, and never hand out the same address twice (even for empty fields)
+    constexpr std::size_t align = alignof(std::max_align_t);
+    const std::size_t size = (std::max<std::size_t>(nBytes, 1) + align - 1) / align * align;
+
+    // move on to the next chunk (making one if needed) if this one is full.
+    // chunks skipped over are too small for this request, but are used again after the next Reset()
+    while (fCurrentChunk < fChunks.size() && fOffset + size > fChunks[fCurrentChunk].size)
+    {
+      fCurrentChunk++;
+      fOffset = 0;
+    }
+    if (fCurrentChunk == fChunks.size())
+    {
+      const std::size_t chunkSize = std::max(fChunkSize, size);
+      fChunks.push_back({std::make_unique<std::max_align_t[]>(chunkSize / align), chunkSize});
+    }
+
+    void * mem = reinterpret_cast<char*>(fChunks[fCurrentChunk].mem.get()) + fOffset;
+    fOffset += size;
+    fBytesInUse += size;
+    return mem;
+  }
+
+  // -----------------------------------------------------------
+
+  void VLArena::Reset()
+  {
+    fCurrentChunk = 0;
+    fOffset = 0;
+    fBytesInUse = 0;
+  }
+
+  // -----------------------------------------------------------
+
+  void * VLArena::H5Allocate(std::size_t nBytes, void * arena)
+  {
+    return static_cast<VLArena*>(arena)->Allocate(nBytes);
+  }
+
+  // -----------------------------------------------------------
+
+  void VLArena::H5Free(void *, void *)
+  {}
+}
@@ -0,0 +1,57 @@
+/// \file VLArena.h
+///
+/// Memory pool that HDF5 allocates variable-length data from when reading a dataset
+///
+
+#ifndef ND_CAFMAKER_VLARENA_H
+#define ND_CAFMAKER_VLARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace cafmaker
+{
+  /// \brief Bump allocator for the payloads of HDF5 variable-length (hvl_t) fields.
+  ///
+  /// Left to itself, HDF5 mallocs every hvl_t buffer separately and expects them to be given back
+  /// one by one with H5Treclaim().  Handed to HDF5 via H5Pset_vlen_mem_manager() (see DatasetBufferBase) instead,
+  /// they're carved out of a few large chunks that are all released at once by Reset().
+  /// The chunks are kept for the next read, so after the first few events there are no allocations at all.
+  class VLArena
+  {
+    public:
+      explicit VLArena(std::size_t chunkSize = 1 << 16);
+
+      VLArena(const VLArena &) = delete;
+      VLArena & operator=(const VLArena &) = delete;
+
+      /// Get `nBytes` of memory, aligned for any type.  Valid until the next Reset()
+      void * Allocate(std::size_t nBytes);
+
+      /// Release everything handed out by Allocate() since the last Reset()
+      void Reset();
+
+      /// How much memory is handed out at the moment
+      std::size_t BytesInUse() const  { return fBytesInUse; }
+
+      /// Callbacks with the signatures H5Pset_vlen_mem_manager() wants.  The info pointer is the VLArena
+      static void * H5Allocate(std::size_t nBytes, void * arena);
+      static void H5Free(void * mem, void * arena);   ///< does nothing: memory only goes back in Reset()
+
+    private:
+      struct Chunk
+      {
+        std::unique_ptr<std::max_align_t[]> mem;
+        std::size_t size;
+      };
+
+      std::size_t fChunkSize;
+      std::vector<Chunk> fChunks;
+      std::size_t fCurrentChunk = 0;
+      std::size_t fOffset = 0;        ///< in bytes, into the current chunk
+      std::size_t fBytesInUse = 0;
+  };
+}
+
+#endif //ND_CAFMAKER_VLARENA_H
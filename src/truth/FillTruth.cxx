@@ -30,6 +30,8 @@
 #include "CAF.h"
 #include "Params.h"
 #include "util/FloatMath.h"
+#include "util/SRPool.h"
+#include "util/Timing.h"
 
 /// duneanaobj not guaranteed to be the same as GENIE scattering types
 caf::ScatteringMode GENIE2CAF(genie::EScatteringType sc)
@@ -134,7 +136,7 @@ namespace cafmaker
   TruthMatcher::TruthMatcher(const std::vector<std::string> & ghepFilenames,
                              std::string edepsimFilename,
                              const genie::NtpMCEventRecord *gEvt,
-                             std::function<int(const genie::NtpMCEventRecord *)> genieFillerCallback)
+                             std::function<int(const genie::NtpMCEventRecord *, const GENIEEventRef &)> genieFillerCallback)
     : cafmaker::Loggable("TruthMatcher"),
       fGTrees(ghepFilenames, gEvt),
       fGENIEWriterCallback(std::move(genieFillerCallback)),
@@ -321,8 +323,8 @@ namespace cafmaker
   caf::SRTrueParticle &
   TruthMatcher::GetTrueParticle(caf::StandardRecord &sr, caf::SRTrueInteraction& ixn, int G4ID, bool isPrimary, bool createNew) const
   {
-    static SRPartCmp srPartCmp;
-    srPartCmp.partID = G4ID;
+    // not static: several TruthMatchers may be working in parallel threads
+    SRPartCmp srPartCmp{G4ID};
     return GetTrueParticle(sr, ixn, G4ID, srPartCmp, isPrimary, createNew);
   }
 
@@ -433,7 +435,7 @@ namespace cafmaker
           throw exc;
         }
       }
-      sr.mc.nu.emplace_back();
+      sr.mc.nu.push_back(SRPool<caf::SRTrueInteraction>::Acquire());
       sr.mc.nnu++;
       ixn = &sr.mc.nu.back();
       ixn->id = ixnID;
@@ -447,7 +449,7 @@ namespace cafmaker
 
         // this bit of info can't be extracted directly from the GENIE record,
         // so we do it here
-        ixn->genieIdx = fGENIEWriterCallback(fGTrees.GEvt());  // copy the GENIE event into the CAF output GENIE tree
+        ixn->genieIdx = fGENIEWriterCallback(fGTrees.GEvt(), fGTrees.EvtRef());  // copy the GENIE event (or its location) into the CAF output GENIE tree
 
         FillInteraction(*ixn, fGTrees.GEvt(), fEdepSimTree.G4Event(), sr.mc.nnu);  // copy values from the GENIE event into the StandardRecord
 
@@ -539,8 +541,9 @@ namespace cafmaker
   TruthMatcher::GTreeContainer::GTreeContainer(const vector<std::string> &filenames, const genie::NtpMCEventRecord * gEvt)
     : cafmaker::Loggable("GTreeContainer"), fGEvt(gEvt)
   {
-    for (const auto & fname : filenames)
+    for (std::size_t fileIdx = 0; fileIdx < filenames.size(); fileIdx++)
     {
+      const std::string & fname = filenames[fileIdx];
       if (fname.empty())
         continue;
 
@@ -588,6 +591,7 @@ namespace cafmaker
       }
 
       fGTrees[run] = tree;
+      fFileIdx[run] = static_cast<int>(fileIdx);
       tree->SetBranchAddress("gmcrec", &fGEvt);
 
       LOG.INFO() << "Loaded TTree for run " << run << " from file: " << fname << "\n";
@@ -631,6 +635,7 @@ namespace cafmaker
   // ------------------------------------------------------------
   void TruthMatcher::EdepSimTreeContainer::SelectEvent(unsigned long vertex_id)
   {
+    cafmaker::ScopedTimer timer("TruthMatcher::edep-sim");
     if (!f_isTreeLoaded)
     {
       LoadTree();
@@ -660,6 +665,7 @@ namespace cafmaker
   // ------------------------------------------------------------
   void TruthMatcher::GTreeContainer::SelectEvent(unsigned long runNum, unsigned int evtNum)
   {
+    cafmaker::ScopedTimer timer("TruthMatcher::GENIE");
     auto it_tree = fGTrees.find(runNum);
     if (it_tree == fGTrees.end())
     {
@@ -669,6 +675,10 @@ namespace cafmaker
       throw std::range_error(ss.str());
     }
     it_tree->second->GetEntry(evtNum);
+
+    fEvtRef.file = fFileIdx.at(runNum);
+    fEvtRef.run = runNum;
+    fEvtRef.entry = evtNum;
   }
 
   // ------------------------------------------------------------
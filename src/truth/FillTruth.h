@@ -17,6 +17,7 @@
 #include <sstream>
 
 #include "fwd.h"
+#include "truth/GENIEStorage.h"
 #include "util/Loggable.h"
 #include "util/FloatMath.h"
   //TG4Event
@@ -131,7 +132,7 @@
       TruthMatcher(const std::vector<std::string> & ghepFilenames,
                   std::string edepsimFilename,
                    const genie::NtpMCEventRecord *gEvt,
-                   std::function<int(const genie::NtpMCEventRecord *)> genieFillerCallback);
+                   std::function<int(const genie::NtpMCEventRecord *, const GENIEEventRef &)> genieFillerCallback);
 
       /// Find a TrueParticle within a given StandardRecord, or, if it doesn't exist, optionally make a new one
       ///
@@ -207,14 +208,19 @@
           const genie::NtpMCEventRecord * GEvt() const;
           void SetGEvtAddr(const genie::NtpMCEventRecord * evt);
 
+          /// Where the event most recently selected with SelectEvent() is
+          const GENIEEventRef & EvtRef() const { return fEvtRef; }
+
         private:
           const genie::NtpMCEventRecord * fGEvt;
           std::map<unsigned long int, TTree*> fGTrees;
+          std::map<unsigned long int, int> fFileIdx;   ///< index of each run's file in the list the container was made with
+          GENIEEventRef fEvtRef;
           std::vector<std::unique_ptr<TFile>> fGFiles;
       };
 
       mutable GTreeContainer fGTrees;
-      std::function<int(const genie::NtpMCEventRecord *)> fGENIEWriterCallback;  ///< Callback function that'll write a copy of a GENIE event out to storage
+      std::function<int(const genie::NtpMCEventRecord *, const GENIEEventRef &)> fGENIEWriterCallback;  ///< Callback function that'll write a GENIE event (or where to find it) out to storage
 
       // Geant4 file (To read secondaries)
 
@@ -0,0 +1,27 @@
+/// \file GENIEStorage.h
+///
+/// How the GENIE records matched to the true interactions are kept in the output
+///
+
+#ifndef ND_CAFMAKER_GENIESTORAGE_H
+#define ND_CAFMAKER_GENIESTORAGE_H
+
+namespace cafmaker
+{
+  enum class GENIEStorage
+  {
+    kCopy,        ///< a copy of the record every time an interaction is matched ('genieEvt' tree)
+    kDedup,       ///< one copy of each distinct record, shared by every interaction it was matched to ('genieEvt' tree)
+    kReference,   ///< only where the record is in the input .ghep files ('genieRef' tree, with the files listed in 'meta')
+  };
+
+  /// Where a GENIE record lives in the input .ghep files
+  struct GENIEEventRef
+  {
+    int file = -1;            ///< index of the .ghep file in the list given to the job (the 'ghep_files' branch of 'meta')
+    unsigned long run = 0;    ///< GENIE run number of that file
+    unsigned int entry = 0;   ///< entry in that file's 'gtree'
+  };
+}
+
+#endif //ND_CAFMAKER_GENIESTORAGE_H
@@ -0,0 +1,79 @@
+/// \file BoundedQueue.h
+///
+/// Fixed-capacity FIFO for handing work from one thread to another
+///
+
+#ifndef ND_CAFMAKER_BOUNDEDQUEUE_H
+#define ND_CAFMAKER_BOUNDEDQUEUE_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace cafmaker
+{
+  /// Thread-safe FIFO with a maximum size.
+  /// Push() waits while the queue is full and Pop() waits while it's empty,
+  /// so a fast producer can't get arbitrarily far ahead of a slow consumer.
+  template <typename T>
+  class BoundedQueue
+  {
+    public:
+      explicit BoundedQueue(std::size_t capacity)
+        : fCapacity(std::max<std::size_t>(capacity, 1))
+      {}
+
+      /// Add an item to the back of the queue, waiting for space if necessary.
+      /// \return false (and drops the item) if the queue was closed
+      bool Push(T item)
+      {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fNotFull.wait(lock, [this]() { return fClosed || fItems.size() < fCapacity; });
+        if (fClosed)
+          return false;
+
+        fItems.push_back(std::move(item));
+        fNotEmpty.notify_one();
+        return true;
+      }
+
+      /// Take the item at the front of the queue, waiting for one if necessary.
+      /// \return false once the queue has been closed and everything in it taken
+      bool Pop(T & item)
+      {
+        std::unique_lock<std::mutex> lock(fMutex);
+        fNotEmpty.wait(lock, [this]() { return fClosed || !fItems.empty(); });
+        if (fItems.empty())
+          return false;
+
+        item = std::move(fItems.front());
+        fItems.pop_front();
+        fNotFull.notify_one();
+        return true;
+      }
+
+      /// No more items will be accepted.
+      /// Anything already queued can still be popped.
+      void Close()
+      {
+        {
+          std::lock_guard<std::mutex> lock(fMutex);
+          fClosed = true;
+        }
+        fNotFull.notify_all();
+        fNotEmpty.notify_all();
+      }
+
+    private:
+      std::size_t fCapacity;
+      bool fClosed = false;
+
+      std::deque<T> fItems;
+      std::mutex fMutex;
+      std::condition_variable fNotFull;
+      std::condition_variable fNotEmpty;
+  };
+}
+
+#endif //ND_CAFMAKER_BOUNDEDQUEUE_H
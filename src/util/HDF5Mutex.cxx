@@ -0,0 +1,13 @@
+#include "HDF5Mutex.h"
+
+namespace cafmaker
+{
+  namespace util
+  {
+    std::recursive_mutex & HDF5Mutex()
+    {
+      static std::recursive_mutex mutex;
+      return mutex;
+    }
+  }
+}
@@ -0,0 +1,21 @@
+/// \file HDF5Mutex.h
+///
+/// Serializing calls into the HDF5 library
+///
+
+#ifndef ND_CAFMAKER_HDF5MUTEX_H
+#define ND_CAFMAKER_HDF5MUTEX_H
+
+#include <mutex>
+
+namespace cafmaker
+{
+  namespace util
+  {
+    /// The HDF5 library we build against isn't thread-safe,
+    /// so everything that calls into it (readers and writers, in every thread) takes this lock first
+    std::recursive_mutex & HDF5Mutex();
+  }
+}
+
+#endif //ND_CAFMAKER_HDF5MUTEX_H
@@ -76,7 +76,12 @@ namespace cafmaker
   // -----------------------------------------------------------------------
   const Logger & LOG_S(const std::string& preamble)
   {
-    return LOG_S() << Logger::Preamble(preamble);
+    // the pending preamble and mute state are mutable,
+    // so each thread streams through its own copy of the global logger
+    // (which always follows the global logger's threshold)
+    thread_local Logger logger("GLOBAL");
+    logger.SetThreshold(LOG_S().GetThreshold());
+    return logger << Logger::Preamble(preamble);
   }
 
 }
@@ -80,7 +80,8 @@ namespace cafmaker
       bool fIsTerm;           ///<  is this output stream a terminal?
   };
 
-  /// Retrieve the global logger for stream use (preamble setting)
+  /// Retrieve the global logger for stream use (preamble setting).
+  /// Safe to use from multiple threads.
   const Logger & LOG_S(const std::string& preamble);
 
   /// Retrieve the global logger object for general use (including setting the log threshold)
@@ -0,0 +1,15 @@
+#include "OutputFilename.h"
+
+namespace cafmaker
+{
+  namespace util
+  {
+    std::string CompanionFilename(const std::string & cafFilename, const std::string & suffix)
+    {
+      static const std::string ext = ".root";
+      if (cafFilename.size() >= ext.size() && cafFilename.compare(cafFilename.size() - ext.size(), ext.size(), ext) == 0)
+        return cafFilename.substr(0, cafFilename.size() - ext.size()) + suffix;
+      return cafFilename + suffix;
+    }
+  }
+}
@@ -0,0 +1,22 @@
+/// \file OutputFilename.h
+///
+/// Names of the files written alongside the CAF
+///
+
+#ifndef ND_CAFMAKER_OUTPUTFILENAME_H
+#define ND_CAFMAKER_OUTPUTFILENAME_H
+
+#include <string>
+
+namespace cafmaker
+{
+  namespace util
+  {
+    /// The name of a file that goes with the CAF `cafFilename`: its '.root' extension replaced by `suffix`
+    /// ("out.root" -> "out.flat.h5" for suffix ".flat.h5").
+    /// If it doesn't end in '.root', `suffix` is just appended, so the result is never the CAF itself
+    std::string CompanionFilename(const std::string & cafFilename, const std::string & suffix);
+  }
+}
+
+#endif //ND_CAFMAKER_OUTPUTFILENAME_H
@@ -0,0 +1,90 @@
+#include "util/SRPool.h"
+
+#include <tuple>
+
+namespace
+{
+  // ------------------------------------------------------------
+  /// Reset `obj` to default values, except that the vectors pointed to by `members`
+  /// keep their memory (though not their contents)
+  template <typename T, typename... Vecs>
+  void ResetKeeping(T & obj, Vecs T::*... members)
+  {
+    std::tuple<Vecs...> kept(std::move(obj.*members)...);
+    obj = T();
+    std::apply([&obj, members...](Vecs &... vecs) { ((vecs.clear(), obj.*members = std::move(vecs)), ...); }, kept);
+  }
+}
+
+namespace cafmaker
+{
+  // ------------------------------------------------------------
+  void ResetKeepCapacity(caf::SRTrueInteraction & nu)
+  {
+    ResetKeeping(nu, &caf::SRTrueInteraction::prim, &caf::SRTrueInteraction::prefsi, &caf::SRTrueInteraction::sec);
+  }
+
+  // ------------------------------------------------------------
+  void ResetKeepCapacity(caf::SRTrack & trk)
+  {
+    ResetKeeping(trk, &caf::SRTrack::truth, &caf::SRTrack::truthOverlap);
+  }
+
+  // ------------------------------------------------------------
+  void ResetKeepCapacity(caf::SRShower & shw)
+  {
+    ResetKeeping(shw, &caf::SRShower::truth, &caf::SRShower::truthOverlap);
+  }
+
+  // ------------------------------------------------------------
+  void ResetKeepCapacity(caf::StandardRecord & sr)
+  {
+    // the tracks and showers go to their pools before the interactions holding them are cleared away
+    for (auto & ixn : sr.nd.lar.dlp)
+    {
+      SRPool<caf::SRTrack>::Recycle(ixn.tracks);
+      SRPool<caf::SRShower>::Recycle(ixn.showers);
+    }
+    for (auto & ixn : sr.nd.lar.pandora)
+    {
+      SRPool<caf::SRTrack>::Recycle(ixn.tracks);
+      SRPool<caf::SRShower>::Recycle(ixn.showers);
+    }
+    for (auto & ixn : sr.nd.minerva.ixn)
+    {
+      SRPool<caf::SRTrack>::Recycle(ixn.tracks);
+      SRPool<caf::SRShower>::Recycle(ixn.showers);
+    }
+    for (auto & ixn : sr.nd.tms.ixn)
+      SRPool<caf::SRTrack>::Recycle(ixn.tracks);
+    SRPool<caf::SRTrueInteraction>::Recycle(sr.mc.nu);
+
+    // these are nested too deep for ResetKeeping()
+    auto nu = std::move(sr.mc.nu);
+    auto larDLP = std::move(sr.nd.lar.dlp);
+    auto larPandora = std::move(sr.nd.lar.pandora);
+    auto larFlashes = std::move(sr.nd.lar.flashes);
+    auto tmsIxn = std::move(sr.nd.tms.ixn);
+    auto minervaIxn = std::move(sr.nd.minerva.ixn);
+    auto trkMatchExtrap = std::move(sr.nd.trkmatch.extrap);
+    auto commonDLP = std::move(sr.common.ixn.dlp);
+    auto commonPandora = std::move(sr.common.ixn.pandora);
+
+    sr = caf::StandardRecord();
+
+    auto putBack = [](auto & from, auto & to)
+    {
+      from.clear();
+      to = std::move(from);
+    };
+    putBack(nu, sr.mc.nu);
+    putBack(larDLP, sr.nd.lar.dlp);
+    putBack(larPandora, sr.nd.lar.pandora);
+    putBack(larFlashes, sr.nd.lar.flashes);
+    putBack(tmsIxn, sr.nd.tms.ixn);
+    putBack(minervaIxn, sr.nd.minerva.ixn);
+    putBack(trkMatchExtrap, sr.nd.trkmatch.extrap);
+    putBack(commonDLP, sr.common.ixn.dlp);
+    putBack(commonPandora, sr.common.ixn.pandora);
+  }
+}
@@ -0,0 +1,74 @@
+/// \file SRPool.h
+///
+/// Reuse of StandardRecord memory from one trigger to the next
+///
+
+#ifndef ND_CAFMAKER_SRPOOL_H
+#define ND_CAFMAKER_SRPOOL_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "duneanaobj/StandardRecord/StandardRecord.h"
+
+namespace cafmaker
+{
+  /// \name Reset to default values, keeping the memory of the vectors that get refilled every trigger
+  /// @{
+  void ResetKeepCapacity(caf::SRTrueInteraction & nu);  ///< keeps `prim`, `prefsi` and `sec`
+  void ResetKeepCapacity(caf::SRTrack & trk);           ///< keeps `truth` and `truthOverlap`
+  void ResetKeepCapacity(caf::SRShower & shw);          ///< keeps `truth` and `truthOverlap`
+
+  /// Keeps the record's own vectors (true interactions, each detector's interactions, flashes, the common interactions, ...),
+  /// and hands the true interactions, tracks and showers in them to their `SRPool`s
+  void ResetKeepCapacity(caf::StandardRecord & sr);
+  /// @}
+
+  /// \brief Spare record elements whose own vectors still have their memory, kept for the next trigger.
+  ///
+  /// Elements go in when a record is reset with `ResetKeepCapacity()`, and come back out
+  /// where the fillers make new ones.  The spares are per thread, so there's no locking,
+  /// and at most `kMaxSpares` of each type are kept (per thread).
+  template <typename T>
+  class SRPool
+  {
+    public:
+      static constexpr std::size_t kMaxSpares = 4096;
+
+      /// A default-valued element, reusing a spare's memory if there is one
+      static T Acquire()
+      {
+        std::vector<T> & spares = Spares();
+        if (spares.empty())
+          return T();
+
+        T elem = std::move(spares.back());
+        spares.pop_back();
+        return elem;
+      }
+
+      /// Reset every element of `elems` and keep it as a spare.  `elems` is left empty (with its capacity intact)
+      static void Recycle(std::vector<T> & elems)
+      {
+        std::vector<T> & spares = Spares();
+        for (T & elem : elems)
+        {
+          if (spares.size() >= kMaxSpares)
+            break;
+          ResetKeepCapacity(elem);
+          spares.push_back(std::move(elem));
+        }
+        elems.clear();
+      }
+
+    private:
+      static std::vector<T> & Spares()
+      {
+        static thread_local std::vector<T> spares;
+        return spares;
+      }
+  };
+}
+
+#endif //ND_CAFMAKER_SRPOOL_H
@@ -0,0 +1,148 @@
+#include "util/Timing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+namespace
+{
+  // histogram binning: 8 bins per factor of 2, starting at 100 ns
+  const double kHistMin_s = 1e-7;
+  const double kBinsPerOctave = 8;
+  const std::size_t kNBins = 240;   // up to ~100 s
+
+  std::size_t DurationBin(double seconds)
+  {
+    if (!(seconds > kHistMin_s))
+      return 0;
+    return std::min(static_cast<std::size_t>(std::log2(seconds / kHistMin_s) * kBinsPerOctave), kNBins - 1);
+  }
+
+  // geometric center of a bin
+  double BinCenter(std::size_t bin)
+  {
+    return kHistMin_s * std::exp2((static_cast<double>(bin) + 0.5) / kBinsPerOctave);
+  }
+}
+
+namespace cafmaker
+{
+  // -----------------------------------------------------------
+  TimingStage::TimingStage()
+    : fHistogram(kNBins, 0)
+  {}
+
+  // -----------------------------------------------------------
+  void TimingStage::Record(double seconds)
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fCalls++;
+    fTotal += seconds;
+    fMax = std::max(fMax, seconds);
+    fHistogram[DurationBin(seconds)]++;
+  }
+
+  // -----------------------------------------------------------
+  std::size_t TimingStage::Calls() const
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fCalls;
+  }
+
+  // -----------------------------------------------------------
+  double TimingStage::Total() const
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fTotal;
+  }
+
+  // -----------------------------------------------------------
+  double TimingStage::Max() const
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fMax;
+  }
+
+  // -----------------------------------------------------------
+  double TimingStage::Percentile(double frac) const
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (fCalls == 0)
+      return 0;
+
+    const double target = frac * static_cast<double>(fCalls);
+    std::size_t cumulative = 0;
+    for (std::size_t bin = 0; bin < fHistogram.size(); bin++)
+    {
+      cumulative += fHistogram[bin];
+      if (static_cast<double>(cumulative) >= target)
+        return std::min(BinCenter(bin), fMax);
+    }
+    return fMax;
+  }
+
+  // -----------------------------------------------------------
+  Timing & Timing::Get()
+  {
+    static Timing timing;
+    return timing;
+  }
+
+  // -----------------------------------------------------------
+  TimingStage & Timing::Stage(const std::string & name)
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    return fStages[name];   // std::map never moves its elements, so handing out the reference is safe
+  }
+
+  // -----------------------------------------------------------
+  void Timing::WriteJSON(const std::string & filename) const
+  {
+    nlohmann::json stages = nlohmann::json::object();
+    {
+      std::lock_guard<std::mutex> lock(fMutex);
+      for (const auto & namedStage : fStages)
+      {
+        const TimingStage & stage = namedStage.second;
+        const std::size_t calls = stage.Calls();
+        stages[namedStage.first] = {
+          {"calls",   calls},
+          {"total_s", stage.Total()},
+          {"mean_s",  calls > 0 ? stage.Total() / static_cast<double>(calls) : 0.},
+          {"p50_s",   stage.Percentile(0.50)},
+          {"p90_s",   stage.Percentile(0.90)},
+          {"p99_s",   stage.Percentile(0.99)},
+          {"max_s",   stage.Max()},
+        };
+      }
+    }
+
+    std::ofstream outFile(filename);
+    if (!outFile)
+      throw std::runtime_error("Couldn't open timing report file '" + filename + "' for writing");
+    outFile << nlohmann::json{{"stages", stages}}.dump(2) << "\n";
+  }
+
+  // -----------------------------------------------------------
+  ScopedTimer::ScopedTimer(const std::string & stageName)
+    : ScopedTimer(Timing::Get().Enabled() ? &Timing::Get().Stage(stageName) : nullptr)
+  {}
+
+  // -----------------------------------------------------------
+  ScopedTimer::ScopedTimer(TimingStage * stage)
+    : fStage(stage)
+  {
+    if (fStage)
+      fStart = std::chrono::steady_clock::now();
+  }
+
+  // -----------------------------------------------------------
+  ScopedTimer::~ScopedTimer()
+  {
+    if (fStage)
+      fStage->Record(std::chrono::duration<double>(std::chrono::steady_clock::now() - fStart).count());
+  }
+}
@@ -0,0 +1,89 @@
+/// \file Timing.h
+///
+/// Wall-clock instrumentation for the stages of CAF making
+///
+
+#ifndef ND_CAFMAKER_TIMING_H
+#define ND_CAFMAKER_TIMING_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cafmaker
+{
+  /// Cumulative timing for one stage: number of calls, total and maximum time,
+  /// and a histogram of call durations (eight logarithmic bins per factor of two, from 100 ns to ~100 s)
+  /// from which latency percentiles are estimated.
+  /// Can be recorded into from any thread.
+  class TimingStage
+  {
+    public:
+      TimingStage();
+
+      void Record(double seconds);
+
+      std::size_t Calls() const;
+      double Total() const;
+      double Max() const;
+
+      /// Estimated duration (in s) that the fraction `frac` of calls took less than
+      double Percentile(double frac) const;
+
+    private:
+      mutable std::mutex fMutex;
+      std::size_t fCalls = 0;
+      double fTotal = 0;
+      double fMax = 0;
+      std::vector<std::size_t> fHistogram;
+  };
+
+  /// The process-wide collection of TimingStages
+  class Timing
+  {
+    public:
+      static Timing & Get();
+
+      /// Timing is off (and ScopedTimers do nothing) until enabled
+      void Enable(bool enable = true)  { fEnabled = enable; }
+      bool Enabled() const             { return fEnabled; }
+
+      /// Look up (or create) a stage.  The reference stays valid for the life of the program.
+      TimingStage & Stage(const std::string & name);
+
+      /// Write the statistics for every stage to a JSON file
+      void WriteJSON(const std::string & filename) const;
+
+    private:
+      Timing() = default;
+
+      std::atomic<bool> fEnabled{false};
+      mutable std::mutex fMutex;
+      std::map<std::string, TimingStage> fStages;
+  };
+
+  /// Times its own lifetime, and records it to a TimingStage on destruction.
+  /// Does nothing if timing isn't enabled when it's constructed.
+  class ScopedTimer
+  {
+    public:
+      explicit ScopedTimer(const std::string & stageName);
+
+      /// For hot spots: pass a stage that was looked up ahead of time (or nullptr to do nothing)
+      explicit ScopedTimer(TimingStage * stage);
+
+      ScopedTimer(const ScopedTimer &) = delete;
+      ScopedTimer & operator=(const ScopedTimer &) = delete;
+
+      ~ScopedTimer();
+
+    private:
+      TimingStage * fStage = nullptr;
+      std::chrono::steady_clock::time_point fStart;
+  };
+}
+
+#endif //ND_CAFMAKER_TIMING_H
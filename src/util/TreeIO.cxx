@@ -0,0 +1,196 @@
+#include "util/TreeIO.h"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <stdexcept>
+
+#include "Compression.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TTree.h"
+
+#include "Params.h"
+#include "util/Logger.h"
+
+namespace
+{
+  // ------------------------------------------------------------
+  /// Regex matching the names `pattern` (with '*' and '?' wildcards) matches, and everything below them
+  std::regex GlobToRegex(const std::string & pattern)
+  {
+    std::string re = "^";
+    for (char c : pattern)
+    {
+      if (c == '*')
+        re += ".*";
+      else if (c == '?')
+        re += '.';
+      else if (std::string("\\^$.|+()[]{}").find(c) != std::string::npos)
+        re += std::string("\\") + c;
+      else
+        re += c;
+    }
+    re += "(\\..*)?$";
+
+    return std::regex(re);
+  }
+
+  // ------------------------------------------------------------
+  std::size_t DisableBranches(TObjArray & branches, const cafmaker::BranchSelection & selection, const std::string & prefix)
+  {
+    std::size_t nDisabled = 0;
+    for (TObject * obj : branches)
+    {
+      auto br = static_cast<TBranch*>(obj);
+      std::string name = br->GetName();
+      if (!prefix.empty() && name != prefix && name.compare(0, prefix.size() + 1, prefix + ".") != 0)
+        name = prefix + "." + name;
+
+      // a disabled branch doesn't fill its sub-branches either
+      if (!selection.Keep(name))
+      {
+        br->SetBit(TBranch::kDoNotProcess);
+        nDisabled++;
+      }
+      else
+        nDisabled += DisableBranches(*br->GetListOfBranches(), selection, prefix);
+    }
+
+    return nDisabled;
+  }
+}
+
+namespace cafmaker
+{
+  // ------------------------------------------------------------
+  BranchSelection::BranchSelection(const std::vector<std::string> & exclude, const std::vector<std::string> & include)
+  {
+    for (const std::string & pattern : exclude)
+      fExclude.push_back(GlobToRegex(pattern));
+    for (const std::string & pattern : include)
+    {
+      fInclude.push_back(GlobToRegex(pattern));
+      fIncludePrefixes.push_back(pattern.substr(0, pattern.find_first_of("*?")));
+    }
+  }
+
+  // ------------------------------------------------------------
+  bool BranchSelection::Keep(const std::string & name) const
+  {
+    auto matches = [&name](const std::regex & re) { return std::regex_match(name, re); };
+    if (std::none_of(fExclude.begin(), fExclude.end(), matches))
+      return true;
+    if (std::any_of(fInclude.begin(), fInclude.end(), matches))
+      return true;
+
+    // something further down is wanted, so this level has to stay
+    const std::string below = name + ".";
+    return std::any_of(fIncludePrefixes.begin(), fIncludePrefixes.end(),
+                       [&below](const std::string & prefix) { return prefix.compare(0, below.size(), below) == 0; });
+  }
+
+  // ------------------------------------------------------------
+  int CompressionSettings(const std::string & algorithm, int level)
+  {
+    if (algorithm.empty())
+      return -1;
+
+    // default levels are ROOT's (see ROOT::RCompressionSetting::ELevel)
+    static const std::map<std::string, std::pair<ROOT::ECompressionAlgorithm, int>> kAlgorithms
+    {
+      {"ZLIB", {ROOT::kZLIB, 1}},
+      {"LZ4",  {ROOT::kLZ4,  4}},
+      {"ZSTD", {ROOT::kZSTD, 5}},
+      {"LZMA", {ROOT::kLZMA, 7}},
+    };
+
+    std::string name = algorithm;
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return std::toupper(c); });
+    auto it = kAlgorithms.find(name);
+    if (it == kAlgorithms.end())
+      throw std::invalid_argument("Unknown compression algorithm '" + algorithm + "' (expected ZSTD, LZ4, ZLIB or LZMA)");
+    if (level > 9)
+      throw std::invalid_argument("Compression level must be 0-9, not " + std::to_string(level));
+
+    return ROOT::CompressionSettings(it->second.first, level < 0 ? it->second.second : level);
+  }
+
+  // ------------------------------------------------------------
+  TreeIOSettings MakeTreeIOSettings(const TreeIOConfig & cfg)
+  {
+    TreeIOSettings settings;
+    settings.compression = CompressionSettings(cfg.compressionAlgorithm(), cfg.compressionLevel());
+    settings.basketSize = cfg.basketSize();
+
+    long long val = 0;
+    if (cfg.autoFlush(val))
+      settings.autoFlush = val;
+    if (cfg.autoSave(val))
+      settings.autoSave = val;
+
+    settings.autoTuneEntries = cfg.autoTuneEntries();
+    settings.autoTuneMemory = cfg.autoTuneMemory();
+
+    return settings;
+  }
+
+  // ------------------------------------------------------------
+  void ApplyTreeIOSettings(TTree & tree, const TreeIOSettings & settings)
+  {
+    // sets the sub-branches too
+    if (settings.compression >= 0)
+    {
+      for (TObject * br : *tree.GetListOfBranches())
+        static_cast<TBranch*>(br)->SetCompressionSettings(settings.compression);
+    }
+
+    if (settings.basketSize > 0)
+      tree.SetBasketSize("*", settings.basketSize);
+
+    if (settings.autoFlush)
+      tree.SetAutoFlush(*settings.autoFlush);
+
+    if (settings.autoSave)
+      tree.SetAutoSave(*settings.autoSave);
+  }
+
+  // ------------------------------------------------------------
+  std::size_t ApplyBranchSelection(TTree & tree, const BranchSelection & selection, const std::string & prefix)
+  {
+    if (selection.All())
+      return 0;
+
+    std::size_t nDisabled = DisableBranches(*tree.GetListOfBranches(), selection, prefix);
+
+    // arrays that are kept can't be read back without their lengths
+    for (TObject * obj : *tree.GetListOfLeaves())
+    {
+      auto leaf = static_cast<TLeaf*>(obj);
+      TLeaf * countLeaf = leaf->GetLeafCount();
+      if (!countLeaf || leaf->GetBranch()->TestBit(TBranch::kDoNotProcess) || !countLeaf->GetBranch()->TestBit(TBranch::kDoNotProcess))
+        continue;
+      countLeaf->GetBranch()->ResetBit(TBranch::kDoNotProcess);
+      nDisabled--;
+    }
+
+    if (nDisabled > 0)
+      LOG_S("ApplyBranchSelection()").INFO() << "Not writing " << nDisabled << " branches of tree '" << tree.GetName() << "'\n";
+
+    return nDisabled;
+  }
+
+  // ------------------------------------------------------------
+  void MaybeAutoTuneBaskets(TTree & tree, const TreeIOSettings & settings)
+  {
+    if (settings.autoTuneEntries == 0 || tree.GetEntries() != static_cast<Long64_t>(settings.autoTuneEntries))
+      return;
+
+    LOG_S("MaybeAutoTuneBaskets()").INFO() << "Resizing the baskets of tree '" << tree.GetName() << "' to fit its first "
+                                           << settings.autoTuneEntries << " entries\n";
+
+    // the baskets filled so far are what the new sizes are computed from
+    tree.FlushBaskets();
+    tree.OptimizeBaskets(settings.autoTuneMemory, 1.1, "");
+  }
+}
@@ -0,0 +1,98 @@
+/// \file TreeIO.h
+///
+/// Compression, basket and branch selection settings for the output trees
+///
+
+#ifndef ND_CAFMAKER_TREEIO_H
+#define ND_CAFMAKER_TREEIO_H
+
+#include <optional>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "Rtypes.h"
+
+class TTree;
+
+namespace cafmaker
+{
+  struct TreeIOConfig;
+
+  /// How one output tree is written
+  struct TreeIOSettings
+  {
+    int compression = -1;                 ///< ROOT compression settings (100 * algorithm + level).  < 0 keeps the file's setting
+    int basketSize  = 0;                  ///< initial basket size (bytes) for every branch.  0 keeps ROOT's default
+    std::optional<Long64_t> autoFlush;    ///< passed to TTree::SetAutoFlush() if set
+    std::optional<Long64_t> autoSave;     ///< passed to TTree::SetAutoSave() if set
+    unsigned int autoTuneEntries = 0;     ///< resize the baskets once the tree has this many entries.  0 never does
+    Long64_t autoTuneMemory = 30000000;   ///< total basket memory (bytes) the resizing distributes
+  };
+
+  /// \brief Which output branches get written, from exclude patterns (with exceptions).
+  ///
+  /// Names are the full dotted names, like "rec.mc.nu.sec" or "rec.nd.lar.flashes.pe_per_ch" ('*' and '?' are wildcards).
+  /// A pattern matching a branch matches everything below it too.
+  class BranchSelection
+  {
+    public:
+      /// Keeps everything
+      BranchSelection() = default;
+
+      /// \param exclude  Branches not to write
+      /// \param include  Exceptions to `exclude`
+      BranchSelection(const std::vector<std::string> & exclude, const std::vector<std::string> & include);
+
+      /// Is the branch `name` written?
+      bool Keep(const std::string & name) const;
+
+      /// Keeps everything?
+      bool All() const  { return fExclude.empty(); }
+
+    private:
+      std::vector<std::regex> fExclude;
+      std::vector<std::regex> fInclude;
+      std::vector<std::string> fIncludePrefixes;  ///< the part of each include pattern before its first wildcard
+  };
+
+  /// Settings for each of the trees in the output CAF(s)
+  struct CAFTreeIO
+  {
+    TreeIOSettings cafTree;
+    TreeIOSettings genieTree;
+    TreeIOSettings mvaTree;
+    TreeIOSettings flatCAFTree;
+
+    BranchSelection branches;   ///< applies to the StandardRecord in every output, and to the MVA tree
+  };
+
+  /// \brief ROOT compression settings for an algorithm given by name
+  ///
+  /// \param algorithm  ZSTD, LZ4, ZLIB or LZMA (case doesn't matter).  Empty means 'not set'
+  /// \param level      Compression level.  < 0 means ROOT's default for the algorithm
+  /// \return  The settings, or -1 if `algorithm` is empty
+  int CompressionSettings(const std::string & algorithm, int level);
+
+  /// Convert the FHiCL configuration for one tree
+  TreeIOSettings MakeTreeIOSettings(const TreeIOConfig & cfg);
+
+  /// Apply the compression, basket size, AutoFlush and AutoSave settings.
+  /// Call once the tree's branches have all been made
+  void ApplyTreeIOSettings(TTree & tree, const TreeIOSettings & settings);
+
+  /// \brief Stop the branches `selection` doesn't keep from being filled (and so streamed and compressed).
+  ///
+  /// They stay in the tree, empty.  Branches holding the lengths of kept arrays are always kept.
+  /// Branch names that don't start with `prefix` (the names of split sub-branches) are checked with it prepended.
+  /// Call once the tree's branches have all been made
+  ///
+  /// \return  The number of branches disabled
+  std::size_t ApplyBranchSelection(TTree & tree, const BranchSelection & selection, const std::string & prefix = "rec");
+
+  /// Call after every Fill(): resizes the baskets from what's been filled so far,
+  /// once the tree reaches `settings.autoTuneEntries` entries
+  void MaybeAutoTuneBaskets(TTree & tree, const TreeIOSettings & settings);
+}
+
+#endif //ND_CAFMAKER_TREEIO_H